@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Throughput of channel, compared to a mutex protected queue,
+// for a single consumer and 1 to 16 producers.
+
+#include <cor3ntin/rangesnext/channel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+constexpr int elements = 4'000'000;
+constexpr std::size_t queue_capacity = 1024;
+
+// What channel replaces
+template <typename T>
+class locked_queue {
+  public:
+    void push(T value) {
+        std::unique_lock lock(m_mutex);
+        m_not_full.wait(lock, [this] { return m_queue.size() < queue_capacity; });
+        m_queue.push_back(std::move(value));
+        lock.unlock();
+        m_not_empty.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return !m_queue.empty() || m_closed; });
+        if (m_queue.empty())
+            return std::nullopt;
+        T value = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_not_full.notify_one();
+        return value;
+    }
+
+    void close() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_closed = true;
+        }
+        m_not_empty.notify_all();
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<T> m_queue;
+    bool m_closed = false;
+};
+
+template <typename Queue, typename Push, typename Consume>
+double run(int producers, Push push, Consume consume) {
+    Queue q;
+    const auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    {
+        std::vector<std::jthread> threads;
+        for (int p = 0; p < producers; ++p)
+            threads.emplace_back([&, p] { push(q, p * (elements / producers), (p + 1) * (elements / producers)); });
+        std::jthread consumer([&] { sum = consume(q); });
+        threads.clear();
+        q.close();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (sum < 0)
+        std::puts("unreachable");
+    return (elements / producers) * producers / elapsed.count() / 1e6;
+}
+
+struct sized_channel : channel<int> {
+    sized_channel() : channel<int>(queue_capacity) {
+    }
+};
+
+} // namespace
+
+int main() {
+    std::printf("%-10s %14s %14s %14s\n", "producers", "mutex Mops/s", "channel Mops/s", "batched Mops/s");
+    for (int producers : {1, 2, 4, 8, 16}) {
+        const double locked = run<locked_queue<int>>(
+            producers,
+            [](auto &q, int first, int last) {
+                for (int i = first; i < last; ++i)
+                    q.push(i);
+            },
+            [](auto &q) {
+                long long sum = 0;
+                while (auto v = q.pop())
+                    sum += *v;
+                return sum;
+            });
+
+        const double single = run<sized_channel>(
+            producers,
+            [](auto &q, int first, int last) {
+                for (int i = first; i < last; ++i)
+                    q.push(i);
+            },
+            [](auto &q) {
+                long long sum = 0;
+                for (int v : q.consume())
+                    sum += v;
+                return sum;
+            });
+
+        const double batched = run<sized_channel>(
+            producers,
+            [](auto &q, int first, int last) {
+                for (int i = first; i < last; i += 64)
+                    q.push_range(std::views::iota(i, std::min(i + 64, last)));
+            },
+            [](auto &q) {
+                long long sum = 0;
+                std::vector<int> batch(64);
+                while (auto n = q.pop_some(batch.begin(), batch.size())) {
+                    for (std::size_t i = 0; i < n; ++i)
+                        sum += batch[i];
+                }
+                return sum;
+            });
+
+        std::printf("%-10d %14.1f %14.1f %14.1f\n", producers, locked, single, batched);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Instantiates representative to, product and enumerate pipelines,
+// to measure the compile time of the headers:
+//    cmake --build . --target rangesnext_compile_time
+// reports the time spent in each phase of the compiler (-ftime-report),
+// bench/compile_time/report.sh also counts the instantiated functions.
+
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace rn = cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+template <typename T>
+void use(const T &);
+
+template <int N>
+void pipelines() {
+    std::vector<int> v;
+    std::list<double> l;
+    std::deque<char> d;
+    std::vector<std::pair<int, std::string>> kv;
+
+    use(v | rn::to<std::vector<long>>());
+    use(l | rn::to<std::vector>());
+    use(rn::to<std::set>(d));
+    use(kv | rn::to<std::map>());
+    use(v | r::views::filter([](int i) { return i % N; }) | rn::to<std::deque>());
+
+    use(rn::product(v, l, d) | rn::to<std::vector>());
+    use(rn::product(v, v, v, v, v, v) | rn::to<std::vector>());
+    for (auto &&[a, b, c] : rn::product(v, l, d))
+        use(std::tie(a, b, c));
+    auto p = rn::product(v, d, v, d);
+    use(p.end() - p.begin());
+    use(p.begin() + N);
+    use(p.begin() < p.end());
+
+    for (auto [i, e] : rn::enumerate(l))
+        use(i + e);
+    use(rn::enumerate(v) | rn::to<std::vector>());
+    use(rn::enumerate(rn::product(v, l)) | rn::to<std::vector>());
+
+    std::vector<std::vector<int>> nested;
+    use(rn::to<std::vector<std::list<int>>>(nested));
+    use(nested | rn::to<std::list<std::deque<long>>>());
+}
+
+template void pipelines<1>();
+template void pipelines<2>();
+template void pipelines<3>();
+template void pipelines<4>();
@@ -0,0 +1,14 @@
+#!/bin/sh
+# Reports the compile time of pipelines.cpp by phase,
+# and the number of function template instantiations it emits.
+#    bench/compile_time/report.sh [compiler]
+set -e
+CXX=${1:-${CXX:-g++}}
+DIR=$(dirname "$0")
+OBJ=$(mktemp)
+trap 'rm -f "$OBJ"' EXIT
+
+"$CXX" -std=c++20 -fsyntax-only -ftime-report -I"$DIR/../../include" "$DIR/pipelines.cpp" 2>&1 |
+    grep -E "phase parsing|phase lang. deferred|template instantiation|constraint|TOTAL|Total"
+"$CXX" -std=c++20 -O0 -c -I"$DIR/../../include" "$DIR/pipelines.cpp" -o "$OBJ"
+echo "instantiated functions: $(nm -C --defined-only "$OBJ" | grep -c ' W ')"
@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Conversion of pairs to std::map and flat_map with to,
+// from sorted and shuffled input, with and without sorted_unique.
+// The number of pairs can be given as the first argument.
+
+#include <cor3ntin/rangesnext/flat_map.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+template <typename F>
+void run(const char *name, std::size_t n, F f) {
+    // the first run pays for the page faults of the allocations
+    f();
+    const auto start = std::chrono::steady_clock::now();
+    const auto size = f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-40s %8.2f ns/element (%zu elements)\n", name, elapsed.count() / n, size);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::vector<std::pair<long, long>> sorted(n);
+    for (std::size_t i = 0; i < n; ++i)
+        sorted[i] = {static_cast<long>(i), static_cast<long>(i * 3)};
+    auto shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64());
+
+    std::puts("std::map");
+    run("sorted | to<std::map>()", n, [&] { return (sorted | to<std::map>()).size(); });
+    run("sorted | to<std::map>(sorted_unique)", n, [&] { return (sorted | to<std::map>(sorted_unique)).size(); });
+    run("shuffled | to<std::map>()", n, [&] { return (shuffled | to<std::map>()).size(); });
+
+    std::puts("flat_map");
+    run("sorted | to<flat_map>()", n, [&] { return (sorted | to<flat_map>()).size(); });
+    run("sorted | to<flat_map>(sorted_unique)", n, [&] { return (sorted | to<flat_map>(sorted_unique)).size(); });
+    run("shuffled | to<flat_map>()", n, [&] { return (shuffled | to<flat_map>()).size(); });
+
+    std::puts("lookups of every key, in shuffled order");
+    const auto map = sorted | to<std::map>();
+    const auto flat = sorted | to<flat_map>();
+    run("std::map::find", n, [&] {
+        std::size_t found = 0;
+        for (auto &[k, v] : shuffled)
+            found += map.find(k)->second == v;
+        return found;
+    });
+    run("flat_map::find", n, [&] {
+        std::size_t found = 0;
+        for (auto &[k, v] : shuffled)
+            found += flat.find(k)->second == v;
+        return found;
+    });
+}
@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Conversion of a transformed range to std::unordered_map with to, compared
+// to inserting without reserving, and grouping with group_by compared to
+// the usual m[key].push_back(value) loop, for sorted and shuffled keys.
+// The number of elements can be given as the first argument.
+
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+template <typename F>
+void run(const char *name, std::size_t n, F f) {
+    // the first run pays for the page faults of the allocations
+    f();
+    const auto start = std::chrono::steady_clock::now();
+    const auto size = f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-44s %8.2f ns/element (%zu)\n", name, elapsed.count() / n, size);
+}
+
+using groups_t = std::unordered_map<long, std::vector<long>>;
+
+std::size_t loop(const std::vector<std::pair<long, long>> &rows) {
+    groups_t groups;
+    for (const auto &[k, v] : rows)
+        groups[k].push_back(v);
+    return groups.size();
+}
+
+std::size_t grouped(const std::vector<std::pair<long, long>> &rows) {
+    return to<groups_t>(rows, group_by(&std::pair<long, long>::first, &std::pair<long, long>::second)).size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto pairs = std::views::iota(0l, static_cast<long>(n)) |
+                       std::views::transform([](long i) { return std::pair{i * 7, i}; });
+
+    std::puts("iota | transform | to<std::unordered_map<long, long>>()");
+    run("insert loop, no reserve", n, [&] {
+        std::unordered_map<long, long> m;
+        for (auto p : pairs)
+            m.insert(p);
+        return m.size();
+    });
+    run("to<std::unordered_map<long, long>>()", n, [&] { return (pairs | to<std::unordered_map<long, long>>()).size(); });
+
+    // 64 elements per key on average
+    const std::size_t keys = std::max<std::size_t>(n / 64, 1);
+    std::vector<std::pair<long, long>> sorted(n);
+    for (std::size_t i = 0; i < n; ++i)
+        sorted[i] = {static_cast<long>(i * keys / n), static_cast<long>(i)};
+    auto shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64());
+
+    std::puts("grouping, 64 elements per key");
+    run("sorted keys, m[key].push_back(value)", n, [&] { return loop(sorted); });
+    run("sorted keys, to<groups>(group_by)", n, [&] { return grouped(sorted); });
+    run("shuffled keys, m[key].push_back(value)", n, [&] { return loop(shuffled); });
+    run("shuffled keys, to<groups>(group_by)", n, [&] { return grouped(shuffled); });
+}
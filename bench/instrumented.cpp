@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Reports the iterator operations performed on each stage of
+// enumerate, product and to pipelines, per produced element.
+
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/instrumented.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+struct stage {
+    const char *name;
+    iterator_counters counters;
+};
+
+template <typename F>
+void report(const char *pipeline, std::size_t elements, std::vector<stage> &stages, F run) {
+    for (auto &s : stages)
+        s.counters.reset();
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%s: %zu elements, %.2f ns/element (instrumented)\n", pipeline, elements, elapsed.count() / elements);
+    std::printf("  %-12s %8s %8s %8s %8s %8s %8s %8s %8s\n", "stage", "begin", "end", "++", "--", "+=", "*", "==",
+                "-");
+    for (auto &s : stages) {
+        const auto &c = s.counters;
+        const double n = double(elements);
+        std::printf("  %-12s %8llu %8llu %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f\n", s.name,
+                    (unsigned long long)c.begin, (unsigned long long)c.end, c.increments / n, c.decrements / n,
+                    c.advances / n, c.dereferences / n, c.comparisons / n, c.distances / n);
+    }
+    std::puts("");
+}
+
+} // namespace
+
+int main() {
+    std::vector<int> a(1000), b(100), c(10);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 0);
+    std::iota(c.begin(), c.end(), 0);
+    long long sink = 0;
+
+    {
+        std::vector<stage> stages = {{"source", {}}, {"enumerate", {}}};
+        report("for(auto [i, e] : enumerate(a))", a.size(), stages, [&] {
+            for (auto [i, e] : instrumented(enumerate(instrumented(a, stages[0].counters)), stages[1].counters))
+                sink += static_cast<long long>(i) * e;
+        });
+    }
+    {
+        std::vector<stage> stages = {{"a", {}}, {"b", {}}, {"c", {}}, {"product", {}}};
+        auto p = instrumented(product(instrumented(a, stages[0].counters), instrumented(b, stages[1].counters),
+                                      instrumented(c, stages[2].counters)),
+                              stages[3].counters);
+        report("for(auto [x, y, z] : product(a, b, c))", a.size() * b.size() * c.size(), stages, [&] {
+            for (auto [x, y, z] : p)
+                sink += x + y + z;
+        });
+        report("product(a, b, c) | to<std::vector>()", a.size() * b.size() * c.size(), stages,
+               [&] { sink += (p | to<std::vector>()).size(); });
+    }
+    {
+        std::vector<std::vector<int>> nested(1000, std::vector<int>(100, 1));
+        std::vector<stage> stages = {{"outer", {}}};
+        report("nested | to<std::vector<std::list<int>>>()", nested.size(), stages, [&] {
+            sink += (instrumented(nested, stages[0].counters) | to<std::vector<std::list<int>>>()).size();
+        });
+    }
+
+    if (sink == 42)
+        std::puts("");
+}
@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Concatenation of lines into a std::string: views::join | to<std::string>,
+// a += loop, to<std::string> and join_to_string, from a vector of lines and
+// from an input range. The number of lines can be given as the first argument.
+
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+template <typename F>
+void run(const char *name, std::size_t bytes, F f) {
+    // the first run pays for the page faults of the allocations
+    f();
+    const auto start = std::chrono::steady_clock::now();
+    const auto size = f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-40s %8.3f ns/byte (%zu bytes)\n", name, elapsed.count() / bytes, size);
+}
+
+generator<const std::string &> lines_of(const std::vector<std::string> &lines) {
+    for (const auto &line : lines)
+        co_yield line;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    std::vector<std::string> lines;
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        // 10 to 90 characters
+        lines.emplace_back(10 + (i * 37) % 81, static_cast<char>('a' + i % 26));
+        bytes += lines.back().size();
+    }
+
+    std::puts("vector of lines, no separator");
+    run("views::join | to<std::string>()", bytes, [&] { return (lines | std::views::join | to<std::string>()).size(); });
+    run("+= loop", bytes, [&] {
+        std::string s;
+        for (const auto &line : lines)
+            s += line;
+        return s.size();
+    });
+    run("to<std::string>()", bytes, [&] { return (lines | to<std::string>()).size(); });
+
+    std::puts("vector of lines, '\\n' separator");
+    run("+= loop", bytes, [&] {
+        std::string s;
+        for (const auto &line : lines) {
+            if (!s.empty())
+                s += '\n';
+            s += line;
+        }
+        return s.size();
+    });
+    run("join_to_string(lines, '\\n')", bytes, [&] { return join_to_string(lines, '\n').size(); });
+
+    std::puts("generator of lines, '\\n' separator");
+    run("join_to_string(generator, '\\n')", bytes, [&] { return join_to_string(lines_of(lines), '\n').size(); });
+}
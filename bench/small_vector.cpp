@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Cost of to<std::vector>, to<small_vector> and to<static_vector> for
+// small ranges, flat and nested, and of moving the results around.
+
+#include <cor3ntin/rangesnext/small_vector.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <ranges>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+constexpr int iterations = 2'000'000;
+constexpr int inline_size = 16;
+
+template <typename F>
+void run(const char *name, F f) {
+    long long sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        sink += f(i);
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-28s %8.2f ns/iteration%s\n", name, elapsed.count() / iterations, sink == 42 ? " " : "");
+}
+
+template <typename Container>
+long long flat(int i) {
+    // between 0 and 15 elements
+    auto c = std::views::iota(0, i % inline_size) | std::views::filter([](int x) { return x % 3 != 0; }) |
+             to<Container>();
+    return static_cast<long long>(c.size());
+}
+
+template <typename Container>
+long long nested(const std::vector<std::vector<int>> &rows) {
+    auto c = rows | to<std::vector<Container>>();
+    return static_cast<long long>(c.size() + c.back().size());
+}
+
+// Moves each element to another vector and back.
+// Not inlined: GCC optimizes main, which runs once, for size, and the
+// copies of the inline buffers became rep movs there.
+template <typename Container>
+[[gnu::noinline]] long long moves(std::vector<Container> &values, std::vector<Container> &tmp) {
+    tmp.clear();
+    for (auto &v : values)
+        tmp.push_back(std::move(v));
+    values.clear();
+    for (auto &v : tmp)
+        values.push_back(std::move(v));
+    return static_cast<long long>(values.back().size());
+}
+
+template <typename Container>
+std::vector<Container> make_values() {
+    std::vector<Container> values;
+    for (int i = 0; i < 64; ++i)
+        values.push_back(std::views::iota(0, i % inline_size) | to<Container>());
+    return values;
+}
+
+} // namespace
+
+int main() {
+    std::puts("filtered iota (0 to 15 elements) | to<C>()");
+    run("std::vector<int>", flat<std::vector<int>>);
+    run("small_vector<int, 16>", flat<small_vector<int, inline_size>>);
+    run("static_vector<int, 16>", flat<static_vector<int, inline_size>>);
+
+    std::vector<std::vector<int>> rows;
+    for (int i = 0; i < 32; ++i)
+        rows.emplace_back(i % inline_size, i);
+    std::puts("32 rows (0 to 15 elements) | to<std::vector<C>>()");
+    run("std::vector<int>", [&](int) { return nested<std::vector<int>>(rows); });
+    run("small_vector<int, 16>", [&](int) { return nested<small_vector<int, inline_size>>(rows); });
+    run("static_vector<int, 16>", [&](int) { return nested<static_vector<int, inline_size>>(rows); });
+
+    std::puts("move 64 C (0 to 15 elements) to another std::vector<C> and back");
+    auto a = make_values<std::vector<int>>();
+    auto b = make_values<small_vector<int, inline_size>>();
+    auto c = make_values<static_vector<int, inline_size>>();
+    decltype(a) ta;
+    decltype(b) tb;
+    decltype(c) tc;
+    run("std::vector<int>", [&](int) { return moves(a, ta); });
+    run("small_vector<int, 16>", [&](int) { return moves(b, tb); });
+    run("static_vector<int, 16>", [&](int) { return moves(c, tc); });
+}
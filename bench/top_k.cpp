@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+// Best k elements of a product_view: to<std::vector> and partial_sort,
+// compared to top_k and par::top_k, with the peak heap usage of each.
+// The size of each dimension of the product can be given as the first argument.
+
+#include <cor3ntin/rangesnext/parallel.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+#include <cor3ntin/rangesnext/top_k.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> allocated = 0;
+std::atomic<std::size_t> peak = 0;
+
+} // namespace
+
+// Replaced to measure the peak heap usage.
+// Not inlined, so that the compiler doesn't pair malloc and free with new and delete.
+[[gnu::noinline]] void *operator new(std::size_t size) {
+    void *p = std::malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    const std::size_t now = allocated += malloc_usable_size(p);
+    std::size_t previous = peak;
+    while (now > previous && !peak.compare_exchange_weak(previous, now)) {
+    }
+    return p;
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    allocated -= malloc_usable_size(p);
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+using namespace cor3ntin::rangesnext;
+
+namespace {
+
+template <typename F>
+void run(const char *name, std::size_t n, F f) {
+    f();
+    peak = allocated.load();
+    const std::size_t before = allocated;
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-32s %8.2f ns/element, peak %10zu bytes (%d)\n", name, elapsed.count() / n, peak - before,
+                result);
+}
+
+// A cheap score of a point of the product
+constexpr auto score = [](std::tuple<int, int, int> t) {
+    auto [a, b, c] = t;
+    return (a * 7919 + b * 104729 + c * 1299709) % 1000003;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 160;
+    const auto space = product(std::views::iota(0, side), std::views::iota(0, side), std::views::iota(0, side));
+    const std::size_t n = static_cast<std::size_t>(side) * side * side;
+    std::printf("product of 3 iota(0, %d): %zu elements\n", side, n);
+
+    for (std::size_t k : {10u, 1000u}) {
+        std::printf("k = %zu\n", k);
+        auto by_score = [](auto a, auto b) { return score(a) < score(b); };
+        run("to<std::vector> + partial_sort", n, [&] {
+            auto all = space | to<std::vector>();
+            std::ranges::partial_sort(all, all.begin() + static_cast<std::ptrdiff_t>(k), by_score);
+            return score(all.front());
+        });
+        run("top_k", n, [&] { return score(top_k(space, k, std::ranges::less{}, score).front()); });
+        run("par::top_k", n, [&] { return score(par::top_k(space, k, std::ranges::less{}, score).front()); });
+    }
+}
@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+Copyright (c) 2017 - present Lewis Baker
+
+This code has been adapted from cppcoro
+https://github.com/lewissbaker/cppcoro
+
+Licenced under Boost Software License license.
+See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <coroutine>
+#include <cor3ntin/rangesnext/task.hpp>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+// A generator which can co_await, for example on I/O.
+// It is consumed from another coroutine:
+//
+//    for (auto it = co_await gen.begin(); it != gen.end(); (void)co_await ++it) {
+//        use(*it);
+//    }
+//
+// Each yield resumes the consumer directly, and each increment
+// resumes the generator directly.
+template <typename YieldedType, typename ValueType = std::remove_cvref_t<YieldedType>>
+class [[nodiscard]] async_generator {
+    class promise {
+      public:
+        using value_type = ValueType;
+        using reference = std::add_lvalue_reference_t<YieldedType>;
+        using pointer = std::add_pointer_t<reference>;
+
+        auto get_return_object() noexcept {
+            return async_generator{std::coroutine_handle<promise>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        auto final_suspend() const noexcept {
+            return resume_consumer{};
+        }
+
+        auto yield_value(std::remove_reference_t<reference> &&value) noexcept {
+            m_value = std::addressof(value);
+            return resume_consumer{};
+        }
+
+        auto yield_value(std::remove_reference_t<reference> &value) noexcept {
+            m_value = std::addressof(value);
+            return resume_consumer{};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() noexcept {
+            m_exception = std::current_exception();
+        }
+
+        reference value() const noexcept {
+            return *m_value;
+        }
+
+      private:
+        struct resume_consumer {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise> h) noexcept {
+                return h.promise().m_consumer;
+            }
+            void await_resume() const noexcept {
+            }
+        };
+
+        void rethrow_if_exception() {
+            if (m_exception)
+                std::rethrow_exception(std::exchange(m_exception, nullptr));
+        }
+
+        pointer m_value = nullptr;
+        std::coroutine_handle<> m_consumer = nullptr;
+        std::exception_ptr m_exception;
+        friend async_generator;
+    };
+
+    using coroutine_handle = std::coroutine_handle<promise>;
+
+    // Resumes the generator until it yields or completes
+    struct advance_awaiter {
+        coroutine_handle coroutine;
+
+        bool await_ready() const noexcept {
+            return !coroutine || coroutine.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept {
+            coroutine.promise().m_consumer = consumer;
+            return coroutine;
+        }
+
+        void await_resume() {
+            if (coroutine)
+                coroutine.promise().rethrow_if_exception();
+        }
+    };
+
+    struct sentinel {};
+
+    class iterator;
+
+    struct begin_awaiter : advance_awaiter {
+        iterator await_resume() {
+            advance_awaiter::await_resume();
+            return iterator{this->coroutine};
+        }
+    };
+
+    struct increment_awaiter : advance_awaiter {
+        iterator &it;
+        iterator &await_resume() {
+            advance_awaiter::await_resume();
+            return it;
+        }
+    };
+
+    class iterator {
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename promise::value_type;
+        using reference = typename promise::reference;
+
+        iterator() noexcept = default;
+
+        explicit iterator(coroutine_handle coroutine) noexcept : m_coroutine(coroutine) {
+        }
+
+        bool operator==(sentinel) const noexcept {
+            return !m_coroutine || m_coroutine.done();
+        }
+
+        // co_await ++it
+        increment_awaiter operator++() noexcept {
+            return {{m_coroutine}, *this};
+        }
+
+        reference operator*() const noexcept {
+            return m_coroutine.promise().value();
+        }
+
+      private:
+        coroutine_handle m_coroutine = nullptr;
+    };
+
+  public:
+    using promise_type = promise;
+
+    async_generator() = default;
+
+    async_generator(async_generator &&other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {
+    }
+
+    async_generator(const async_generator &other) = delete;
+
+    ~async_generator() {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+        }
+    }
+
+    async_generator &operator=(async_generator &&other) noexcept {
+        std::swap(m_coroutine, other.m_coroutine);
+        return *this;
+    }
+
+    // co_await gen.begin()
+    begin_awaiter begin() noexcept {
+        return {{m_coroutine}};
+    }
+
+    auto end() const noexcept {
+        return sentinel{};
+    }
+
+  private:
+    explicit async_generator(coroutine_handle coroutine) noexcept : m_coroutine(coroutine) {
+    }
+
+    coroutine_handle m_coroutine = nullptr;
+};
+
+// Invokes f on each element of gen, in a task
+template <typename Y, typename V, typename F>
+task<void> for_each(async_generator<Y, V> gen, F f) {
+    auto it = co_await gen.begin();
+    while (it != gen.end()) {
+        std::invoke(f, *it);
+        co_await ++it;
+    }
+}
+
+} // namespace cor3ntin::rangesnext
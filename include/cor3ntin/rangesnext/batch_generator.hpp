@@ -0,0 +1,265 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cstddef>
+#include <exception>
+#include <ranges>
+#include <span>
+
+namespace cor3ntin::rangesnext {
+
+// A generator of small values, which only suspends once every
+// N yielded elements.
+// Values are accumulated in a buffer owned by the promise, which is
+// drained by the iterator without resuming the coroutine.
+// Yielding a span of values publishes it as a batch without copying it,
+// unless it fits in the buffer.
+// An exception escaping the coroutine is rethrown once the values
+// yielded before it are consumed.
+template <typename T, std::size_t N = 256, typename Allocator = void>
+requires std::default_initializable<T> && std::movable<T> && (N > 0)
+class [[nodiscard]] batch_generator {
+    class promise : public detail::frame_allocator_base<Allocator> {
+      public:
+        auto get_return_object() noexcept {
+            return batch_generator{std::coroutine_handle<promise>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept {
+            return {};
+        }
+
+        auto yield_value(const T &value) {
+            m_buffer[m_count++] = value;
+            return full_awaiter{m_count == N};
+        }
+
+        auto yield_value(T &&value) {
+            m_buffer[m_count++] = std::move(value);
+            return full_awaiter{m_count == N};
+        }
+
+        auto yield_value(std::span<const T> values) noexcept {
+            return span_awaiter{*this, values};
+        }
+
+        // Don't allow any use of 'co_await' inside the generator coroutine.
+        template <typename U>
+        std::suspend_never await_transform(U &&value) = delete;
+
+        void return_void() noexcept {
+        }
+
+        // The values of the current batch are delivered first
+        void unhandled_exception() noexcept {
+            m_exception = std::current_exception();
+        }
+
+      private:
+        struct full_awaiter {
+            bool full;
+            bool await_ready() const noexcept {
+                return !full;
+            }
+            void await_suspend(std::coroutine_handle<>) const noexcept {
+            }
+            void await_resume() const noexcept {
+            }
+        };
+
+        struct span_awaiter {
+            promise &p;
+            std::span<const T> values;
+
+            bool await_ready() noexcept {
+                if (values.size() >= N - p.m_count)
+                    return false;
+                for (const T &v : values)
+                    p.m_buffer[p.m_count++] = v;
+                return true;
+            }
+
+            // Publish the buffered values first, if any
+            void await_suspend(std::coroutine_handle<>) noexcept {
+                if (p.m_count == 0)
+                    p.m_external = values;
+                else
+                    p.m_pending = values;
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        // The batch to be consumed
+        std::span<const T> batch() const noexcept {
+            if (!m_external.empty())
+                return m_external;
+            return {m_buffer.data(), m_count};
+        }
+
+        // Drops the consumed batch, returns whether a pending span is available
+        bool next_batch() noexcept {
+            m_count = 0;
+            m_external = std::exchange(m_pending, {});
+            return !m_external.empty();
+        }
+
+        std::array<T, N> m_buffer = {};
+        std::size_t m_count = 0;
+        std::span<const T> m_external;
+        std::span<const T> m_pending;
+        std::exception_ptr m_exception;
+        friend batch_generator;
+    };
+
+    struct sentinel {};
+
+    class iterator {
+        using coroutine_handle = std::coroutine_handle<promise>;
+
+      public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using reference = const T &;
+
+        iterator() noexcept = default;
+        iterator(const iterator &) = delete;
+        iterator(iterator &&o) noexcept {
+            swap(o);
+        }
+
+        iterator &operator=(iterator &&o) noexcept {
+            swap(o);
+            return *this;
+        }
+
+        explicit iterator(coroutine_handle coroutine) : m_coroutine(coroutine) {
+            load();
+        }
+
+        ~iterator() {
+            if (m_coroutine) {
+                m_coroutine.destroy();
+            }
+        }
+
+        bool operator==(sentinel) const noexcept {
+            return m_current == m_end;
+        }
+
+        iterator &operator++() {
+            if (++m_current == m_end)
+                refill();
+            return *this;
+        }
+        void operator++(int) {
+            (void)operator++();
+        }
+
+        reference operator*() const noexcept {
+            return *m_current;
+        }
+
+        const T *operator->() const noexcept {
+            return m_current;
+        }
+
+      private:
+        void swap(iterator &o) noexcept {
+            std::swap(m_coroutine, o.m_coroutine);
+            std::swap(m_current, o.m_current);
+            std::swap(m_end, o.m_end);
+        }
+
+        void refill() {
+            if (!m_coroutine.done()) {
+                if (!m_coroutine.promise().next_batch())
+                    m_coroutine.resume();
+                load();
+            }
+            rethrow_if_exhausted();
+        }
+
+        // Rethrows the exception of the coroutine, once its values are consumed
+        void rethrow_if_exhausted() {
+            if (m_current == m_end && m_coroutine.promise().m_exception)
+                std::rethrow_exception(std::exchange(m_coroutine.promise().m_exception, nullptr));
+        }
+
+        void load() noexcept {
+            auto batch = m_coroutine.promise().batch();
+            m_current = batch.data();
+            m_end = batch.data() + batch.size();
+        }
+
+        coroutine_handle m_coroutine = nullptr;
+        const T *m_current = nullptr;
+        const T *m_end = nullptr;
+        friend batch_generator;
+    };
+
+  public:
+    using promise_type = promise;
+
+    batch_generator() = default;
+
+    batch_generator(batch_generator &&other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {
+    }
+
+    batch_generator(const batch_generator &other) = delete;
+
+    ~batch_generator() {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+        }
+    }
+
+    batch_generator &operator=(batch_generator &&other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    auto begin() {
+        m_coroutine.resume();
+        iterator it{std::exchange(m_coroutine, nullptr)};
+        it.rethrow_if_exhausted();
+        return it;
+    }
+
+    auto end() const noexcept {
+        return sentinel{};
+    }
+
+    void swap(batch_generator &other) noexcept {
+        std::swap(m_coroutine, other.m_coroutine);
+    }
+
+  private:
+    explicit batch_generator(std::coroutine_handle<promise> coroutine) noexcept : m_coroutine(coroutine) {
+    }
+
+    std::coroutine_handle<promise> m_coroutine = nullptr;
+};
+
+} // namespace cor3ntin::rangesnext
+
+namespace std {
+
+template <typename T, std::size_t N, typename A>
+inline constexpr bool ranges::enable_view<cor3ntin::rangesnext::batch_generator<T, N, A>> = true;
+
+}
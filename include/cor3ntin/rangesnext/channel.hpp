@@ -0,0 +1,364 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+// Lets threads sleep until a condition they checked may have changed.
+// A waiter calls prepare(), checks the condition, then either cancel()
+// or wait(); a notifier changes the condition, then calls notify().
+// Both sides read-modify-write m_waiters, so either the notifier sees the
+// waiter, or the waiter sees the change.
+class event_count {
+  public:
+    std::uint32_t prepare() noexcept {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_acquire);
+    }
+
+    void cancel() noexcept {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wait(std::uint32_t epoch) noexcept {
+        m_epoch.wait(epoch, std::memory_order_acquire);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() noexcept {
+        if (m_waiters.fetch_add(0, std::memory_order_seq_cst) != 0)
+            notify_all();
+    }
+
+    void notify_all() noexcept {
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_all();
+    }
+
+  private:
+    std::atomic<std::uint32_t> m_epoch = 0;
+    std::atomic<std::uint32_t> m_waiters = 0;
+};
+
+} // namespace detail
+
+// A bounded multi-producer, multi-consumer queue, which can be closed.
+// Push and pop are lock-free (Dmitry Vyukov's bounded queue), and only
+// block when the channel is full, respectively empty.
+// Once closed, push fails and pop drains the remaining elements.
+template <std::movable T>
+class channel {
+  public:
+    // The capacity is rounded up to a power of 2
+    explicit channel(std::size_t capacity = 1024)
+        : m_mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          m_cells(std::make_unique<cell[]>(m_mask + 1)) {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    channel(const channel &) = delete;
+    channel &operator=(const channel &) = delete;
+
+    ~channel() {
+        while (try_pop()) {
+        }
+    }
+
+    std::size_t capacity() const noexcept {
+        return m_mask + 1;
+    }
+
+    // Returns false if the channel is full or closed,
+    // value is then left untouched, rvalues are only moved from on success
+    bool try_push(const T &value) requires std::copy_constructible<T> {
+        return try_push_one(value);
+    }
+
+    bool try_push(T &&value) {
+        return try_push_one(std::move(value));
+    }
+
+    // Blocks while the channel is full.
+    // Returns false if the channel is closed.
+    bool push(T value) {
+        if (!push_one(value))
+            return false;
+        m_not_empty.notify();
+        return true;
+    }
+
+    // Pushes all the elements of values, waking up the consumers once.
+    // Returns the number of elements pushed, which is less than the size
+    // of values if the channel is closed.
+    template <r::input_range R>
+    requires std::constructible_from<T, r::range_reference_t<R>>
+    std::size_t push_range(R &&values) {
+        std::size_t pushed = 0;
+        if (closed())
+            return pushed;
+        for (auto &&v : values) {
+            T value(std::forward<decltype(v)>(v));
+            if (!try_emplace(std::move(value))) {
+                if (pushed != 0)
+                    m_not_empty.notify();
+                if (!push_one(value))
+                    break;
+            }
+            ++pushed;
+        }
+        if (pushed != 0)
+            m_not_empty.notify();
+        return pushed;
+    }
+
+    std::optional<T> try_pop() {
+        auto value = pop_one();
+        if (value)
+            m_not_full.notify();
+        return value;
+    }
+
+    // Blocks until an element is available.
+    // Returns nullopt once the channel is closed and empty.
+    std::optional<T> pop() {
+        for (int spin = 0;; ++spin) {
+            if (auto value = try_pop())
+                return value;
+            // sleeping and waking up is much more expensive than a few retries
+            if (spin < spin_count) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto epoch = m_not_empty.prepare();
+            if (auto value = try_pop()) {
+                m_not_empty.cancel();
+                return value;
+            }
+            if (closed()) {
+                m_not_empty.cancel();
+                return try_pop();
+            }
+            m_not_empty.wait(epoch);
+        }
+    }
+
+    // Blocks until at least an element is available, then pops up to max
+    // elements to out without blocking, waking up the producers once.
+    // Returns the number of elements popped, 0 once the channel is
+    // closed and empty.
+    template <std::output_iterator<T &&> Out>
+    std::size_t pop_some(Out out, std::size_t max) {
+        if (max == 0)
+            return 0;
+        auto first = pop();
+        if (!first)
+            return 0;
+        *out++ = std::move(*first);
+        std::size_t popped = 1;
+        while (popped < max) {
+            auto value = pop_one();
+            if (!value)
+                break;
+            *out++ = std::move(*value);
+            ++popped;
+        }
+        m_not_full.notify();
+        return popped;
+    }
+
+    // Wakes up all the blocked producers and consumers.
+    // Producers should be done pushing.
+    void close() noexcept {
+        m_closed.store(true, std::memory_order_seq_cst);
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+    bool closed() const noexcept {
+        return m_closed.load(std::memory_order_seq_cst);
+    }
+
+    // The elements popped from the channel until it is closed and empty
+    class consumer_view;
+
+    consumer_view consume() noexcept {
+        return consumer_view{*this};
+    }
+
+  private:
+    static constexpr int spin_count = 16;
+
+    struct cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    // value is only converted to T, or moved from, on success
+    template <typename U>
+    bool try_emplace(U &&value) {
+        std::size_t pos = m_enqueue.load(std::memory_order_relaxed);
+        cell *c;
+        for (;;) {
+            c = &m_cells[pos & m_mask];
+            const auto seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void *>(c->storage)) T(std::forward<U>(value));
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop_one() {
+        std::size_t pos = m_dequeue.load(std::memory_order_relaxed);
+        cell *c;
+        for (;;) {
+            c = &m_cells[pos & m_mask];
+            const auto seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+        T *ptr = std::launder(reinterpret_cast<T *>(c->storage));
+        std::optional<T> value(std::move(*ptr));
+        ptr->~T();
+        c->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return value;
+    }
+
+    template <typename U>
+    bool try_push_one(U &&value) {
+        if (closed() || !try_emplace(std::forward<U>(value)))
+            return false;
+        m_not_empty.notify();
+        return true;
+    }
+
+    // Blocks while the channel is full, does not notify the consumers
+    bool push_one(T &value) {
+        for (int spin = 0;; ++spin) {
+            if (closed())
+                return false;
+            if (try_emplace(std::move(value)))
+                return true;
+            if (spin < spin_count) {
+                std::this_thread::yield();
+                continue;
+            }
+            const auto epoch = m_not_full.prepare();
+            if (closed()) {
+                m_not_full.cancel();
+                return false;
+            }
+            if (try_emplace(std::move(value))) {
+                m_not_full.cancel();
+                return true;
+            }
+            m_not_full.wait(epoch);
+        }
+    }
+
+    const std::size_t m_mask;
+    std::unique_ptr<cell[]> m_cells;
+    alignas(64) std::atomic<std::size_t> m_enqueue = 0;
+    alignas(64) std::atomic<std::size_t> m_dequeue = 0;
+    alignas(64) std::atomic<bool> m_closed = false;
+    detail::event_count m_not_empty;
+    detail::event_count m_not_full;
+};
+
+template <std::movable T>
+class channel<T>::consumer_view : public r::view_interface<consumer_view> {
+    struct sentinel {};
+
+    class iterator {
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+
+        iterator() = default;
+        iterator(iterator &&) = default;
+        iterator &operator=(iterator &&) = default;
+
+        T &operator*() const noexcept {
+            return *m_current;
+        }
+
+        iterator &operator++() {
+            m_current = m_channel->pop();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(sentinel) const noexcept {
+            return !m_current;
+        }
+
+      private:
+        friend consumer_view;
+
+        explicit iterator(channel *c) : m_channel(c), m_current(c->pop()) {
+        }
+
+        channel *m_channel = nullptr;
+        mutable std::optional<T> m_current;
+    };
+
+  public:
+    consumer_view() = default;
+
+    explicit consumer_view(channel &c) noexcept : m_channel(&c) {
+    }
+
+    iterator begin() const {
+        return iterator{m_channel};
+    }
+
+    sentinel end() const noexcept {
+        return {};
+    }
+
+  private:
+    channel *m_channel = nullptr;
+};
+
+} // namespace cor3ntin::rangesnext
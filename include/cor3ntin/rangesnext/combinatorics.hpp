@@ -0,0 +1,434 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cor3ntin/rangesnext/__detail.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+template <typename T, typename Seq>
+struct repeat_tuple;
+
+template <typename T, std::size_t... I>
+struct repeat_tuple<T, std::index_sequence<I...>> {
+    template <std::size_t>
+    using same = T;
+    using type = std::tuple<same<I>...>;
+};
+
+template <typename T, std::size_t K>
+using repeat_tuple_t = typename repeat_tuple<T, std::make_index_sequence<K>>::type;
+
+// Throws when the number of tuples doesn't fit in the difference type
+template <typename D>
+constexpr D checked_multiply(D a, D b) {
+    if (b != 0 && a > std::numeric_limits<D>::max() / b)
+        throw std::overflow_error("combinatorics: too many elements");
+    return a * b;
+}
+
+template <typename D>
+constexpr D binomial(D n, D k) {
+    if (k < 0 || n < 0 || k > n)
+        return 0;
+    if (k > n - k)
+        k = n - k;
+    D res = 1;
+    for (D i = 0; i < k; ++i) {
+        // res * (n - i) is divisible by i + 1, dividing first only
+        // overflows if the result does
+        const D g = std::gcd(res, i + 1);
+        res = checked_multiply(D(res / g), D((n - i) / ((i + 1) / g)));
+    }
+    return res;
+}
+
+// Each policy describes one family of K-tuples of indices into [0, n),
+// enumerated in lexicographic order:
+//  - count(n) is the number of tuples
+//  - unrank(idx, rank, n) computes the tuple at a given position
+//  - next(idx, n) moves to the successor, returning false past the last one
+
+struct combinations_policy {
+    template <std::size_t K, typename D>
+    static constexpr D count(D n) {
+        return binomial(n, D(K));
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr void unrank(std::array<D, K> &idx, D rank, D n) {
+        D c = 0;
+        for (std::size_t i = 0; i < K; ++i) {
+            for (;; ++c) {
+                const D block = binomial(D(n - c - 1), D(K - i - 1));
+                if (rank < block)
+                    break;
+                rank -= block;
+            }
+            idx[i] = c++;
+        }
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr bool next(std::array<D, K> &idx, D n) {
+        for (std::size_t i = K; i-- > 0;) {
+            if (idx[i] < n - D(K - i)) {
+                ++idx[i];
+                for (std::size_t j = i + 1; j < K; ++j)
+                    idx[j] = idx[j - 1] + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct combinations_with_replacement_policy {
+    template <std::size_t K, typename D>
+    static constexpr D count(D n) {
+        if constexpr (K == 0)
+            return 1;
+        else
+            return binomial(D(n + D(K) - 1), D(K));
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr void unrank(std::array<D, K> &idx, D rank, D n) {
+        D c = 0;
+        for (std::size_t i = 0; i < K; ++i) {
+            const D remaining = D(K - i - 1);
+            for (;; ++c) {
+                const D block = remaining == 0 ? D(1) : binomial(D(n - c + remaining - 1), remaining);
+                if (rank < block)
+                    break;
+                rank -= block;
+            }
+            idx[i] = c;
+        }
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr bool next(std::array<D, K> &idx, D n) {
+        for (std::size_t i = K; i-- > 0;) {
+            if (idx[i] < n - 1) {
+                ++idx[i];
+                for (std::size_t j = i + 1; j < K; ++j)
+                    idx[j] = idx[i];
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct permutations_policy {
+    template <std::size_t K, typename D>
+    static constexpr D count(D n) {
+        return arrangements(n, 0, K);
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr void unrank(std::array<D, K> &idx, D rank, D n) {
+        for (std::size_t i = 0; i < K; ++i) {
+            const D block = arrangements(n, i + 1, K);
+            D nth = rank / block;
+            rank %= block;
+            D c = 0;
+            for (;; ++c) {
+                if (used(idx, i, c))
+                    continue;
+                if (nth-- == 0)
+                    break;
+            }
+            idx[i] = c;
+        }
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr bool next(std::array<D, K> &idx, D n) {
+        for (std::size_t i = K; i-- > 0;) {
+            D c = idx[i] + 1;
+            while (c < n && used(idx, i, c))
+                ++c;
+            if (c == n)
+                continue;
+            idx[i] = c;
+            for (std::size_t j = i + 1; j < K; ++j) {
+                D smallest = 0;
+                while (used(idx, j, smallest))
+                    ++smallest;
+                idx[j] = smallest;
+            }
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    // number of ways to fill positions [first, last) from n - first values
+    template <typename D>
+    static constexpr D arrangements(D n, std::size_t first, std::size_t last) {
+        D res = 1;
+        for (std::size_t i = first; i < last; ++i) {
+            if (n <= D(i))
+                return 0;
+            res = checked_multiply(res, D(n - D(i)));
+        }
+        return res;
+    }
+
+    template <std::size_t K, typename D>
+    static constexpr bool used(const std::array<D, K> &idx, std::size_t prefix, D value) {
+        for (std::size_t i = 0; i < prefix; ++i)
+            if (idx[i] == value)
+                return true;
+        return false;
+    }
+};
+
+} // namespace detail
+
+// K-tuples of elements of a sized random access view, selected by Policy.
+// Iterators store the tuple of indices alongside its rank so that
+// increments are amortized O(K), random jumps are O(K^2 * n) at worst,
+// and comparisons and distances only involve the rank.
+// Views with more tuples than their difference type can represent
+// throw std::overflow_error.
+template <r::view V, std::size_t K, typename Policy>
+requires r::random_access_range<V> && r::sized_range<V>
+class combinatoric_view : public r::view_interface<combinatoric_view<V, K, Policy>> {
+
+    V base_ = {};
+
+  public:
+    template <bool Const>
+    struct iterator {
+      private:
+        using parent = std::conditional_t<Const, const combinatoric_view, combinatoric_view>;
+        using Base = std::conditional_t<Const, const V, V>;
+
+      public:
+        using iterator_category = decltype(detail::iter_cat<Base>());
+        using reference = detail::repeat_tuple_t<r::range_reference_t<Base>, K>;
+        using value_type = detail::repeat_tuple_t<r::range_value_t<Base>, K>;
+        using difference_type = r::range_difference_t<Base>;
+
+      private:
+        parent *view_ = nullptr;
+        difference_type rank_ = 0;
+        std::array<difference_type, K> idx_ = {};
+
+        template <bool>
+        friend struct iterator;
+
+      public:
+        iterator() = default;
+
+        constexpr iterator(parent *view, difference_type rank) : view_(view), rank_(rank) {
+            unrank();
+        }
+
+        constexpr iterator(iterator<!Const> i) requires Const
+            && std::convertible_to<r::iterator_t<V>, r::iterator_t<Base>>
+            : view_(i.view_), rank_(i.rank_), idx_(i.idx_) {
+        }
+
+        constexpr auto operator*() const {
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                auto first = r::begin(view_->base_);
+                return reference{first[idx_[I]]...};
+            }
+            (std::make_index_sequence<K>());
+        }
+
+        // The indices of the current elements in the underlying view
+        constexpr const std::array<difference_type, K> &indices() const {
+            return idx_;
+        }
+
+        constexpr iterator &operator++() {
+            ++rank_;
+            Policy::next(idx_, n());
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator--() {
+            --rank_;
+            unrank();
+            return *this;
+        }
+
+        constexpr iterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator+=(difference_type n) {
+            rank_ += n;
+            unrank();
+            return *this;
+        }
+
+        constexpr iterator &operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator+(difference_type n, iterator i) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator-(iterator i, difference_type n) {
+            return i -= n;
+        }
+
+        friend constexpr difference_type operator-(const iterator &x, const iterator &y) {
+            return x.rank_ - y.rank_;
+        }
+
+        constexpr auto operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        friend constexpr bool operator==(const iterator &x, const iterator &y) {
+            return x.rank_ == y.rank_;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(const iterator &x, const iterator &y) {
+            return x.rank_ <=> y.rank_;
+        }
+
+      private:
+        constexpr difference_type n() const {
+            return static_cast<difference_type>(r::size(view_->base_));
+        }
+
+        constexpr void unrank() {
+            const difference_type size = Policy::template count<K>(n());
+            if (rank_ >= 0 && rank_ < size)
+                Policy::unrank(idx_, rank_, n());
+        }
+    };
+
+    constexpr combinatoric_view() = default;
+    constexpr combinatoric_view(V base) : base_(std::move(base)) {
+    }
+
+    constexpr auto begin() requires(!detail::simple_view<V>) {
+        return iterator<false>(this, 0);
+    }
+
+    constexpr auto begin() const requires r::random_access_range<const V> && r::sized_range<const V> {
+        return iterator<true>(this, 0);
+    }
+
+    constexpr auto end() requires(!detail::simple_view<V>) {
+        return iterator<false>(this, static_cast<r::range_difference_t<V>>(size()));
+    }
+
+    constexpr auto end() const requires r::random_access_range<const V> && r::sized_range<const V> {
+        return iterator<true>(this, static_cast<r::range_difference_t<V>>(size()));
+    }
+
+    constexpr auto size() const {
+        using D = r::range_difference_t<V>;
+        return static_cast<std::make_unsigned_t<D>>(Policy::template count<K>(static_cast<D>(r::size(base_))));
+    }
+
+    constexpr V base() const &requires std::copyable<V> {
+        return base_;
+    }
+
+    constexpr V base() && {
+        return std::move(base_);
+    }
+};
+
+template <r::view V, std::size_t K>
+using combinations_view = combinatoric_view<V, K, detail::combinations_policy>;
+
+template <r::view V, std::size_t K>
+using combinations_with_replacement_view = combinatoric_view<V, K, detail::combinations_with_replacement_policy>;
+
+template <r::view V, std::size_t K>
+using permutations_view = combinatoric_view<V, K, detail::permutations_policy>;
+
+namespace detail {
+
+template <std::size_t K, typename Policy>
+struct combinatoric_view_fn {
+    template <r::viewable_range R>
+    requires r::random_access_range<R> && r::sized_range<R>
+    constexpr auto operator()(R &&rng) const {
+        return combinatoric_view<r::views::all_t<R>, K, Policy>{r::views::all(std::forward<R>(rng))};
+    }
+
+    template <r::viewable_range R>
+    requires r::random_access_range<R> && r::sized_range<R>
+    constexpr friend auto operator|(R &&rng, const combinatoric_view_fn &fn) {
+        return fn(std::forward<R>(rng));
+    }
+};
+
+template <std::size_t N>
+struct product_repeat_fn {
+    template <r::viewable_range R>
+    requires r::forward_range<R>
+    constexpr auto operator()(R &&rng) const {
+        auto v = r::views::all(std::forward<R>(rng));
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return product_view{(void(I), v)...};
+        }
+        (std::make_index_sequence<N>());
+    }
+
+    template <r::viewable_range R>
+    requires r::forward_range<R>
+    constexpr friend auto operator|(R &&rng, const product_repeat_fn &fn) {
+        return fn(std::forward<R>(rng));
+    }
+};
+
+} // namespace detail
+
+template <std::size_t K>
+inline detail::combinatoric_view_fn<K, detail::combinations_policy> combinations;
+
+template <std::size_t K>
+inline detail::combinatoric_view_fn<K, detail::combinations_with_replacement_policy> combinations_with_replacement;
+
+template <std::size_t K>
+inline detail::combinatoric_view_fn<K, detail::permutations_policy> permutations;
+
+// product(rng, rng, ..., rng), N times
+template <std::size_t N>
+requires(N > 0) inline detail::product_repeat_fn<N> product_repeat;
+
+} // namespace cor3ntin::rangesnext
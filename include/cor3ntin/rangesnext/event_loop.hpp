@@ -0,0 +1,365 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <coroutine>
+#include <cor3ntin/rangesnext/task.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace cor3ntin::rangesnext {
+
+// A single-threaded reactor, resuming coroutines waiting on
+// file descriptors (sockets, pipes...) or timers.
+// File descriptors are expected to be non-blocking;
+// a file descriptor can be awaited by one reader and one writer at a time.
+class event_loop {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    event_loop() : m_epoll(::epoll_create1(EPOLL_CLOEXEC)) {
+        if (m_epoll < 0)
+            throw std::system_error(errno, std::system_category(), "epoll_create1");
+    }
+
+    event_loop(const event_loop &) = delete;
+    event_loop &operator=(const event_loop &) = delete;
+
+    // Destroys the spawned tasks first: the coroutines they suspend deregister their file descriptors
+    ~event_loop() {
+        m_spawned.clear();
+        ::close(m_epoll);
+    }
+
+    // co_await loop.readable(fd) resumes when fd is readable
+    auto readable(int fd) noexcept {
+        return io_awaiter{*this, fd, EPOLLIN};
+    }
+
+    // co_await loop.writable(fd) resumes when fd is writable
+    auto writable(int fd) noexcept {
+        return io_awaiter{*this, fd, EPOLLOUT};
+    }
+
+    auto sleep_until(clock::time_point deadline) noexcept {
+        return timer_awaiter{*this, deadline};
+    }
+
+    auto sleep_for(clock::duration duration) noexcept {
+        return sleep_until(clock::now() + duration);
+    }
+
+    // Resumes the awaiting coroutine on the next iteration of the loop
+    auto schedule() noexcept {
+        return timer_awaiter{*this, clock::time_point::min()};
+    }
+
+    // Reads up to buffer.size() bytes, returns 0 at end of file
+    task<std::size_t> read_some(int fd, std::span<std::byte> buffer) {
+        for (;;) {
+            const auto n = ::read(fd, buffer.data(), buffer.size());
+            if (n >= 0)
+                co_return static_cast<std::size_t>(n);
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                throw std::system_error(errno, std::system_category(), "read");
+            co_await readable(fd);
+        }
+    }
+
+    // Writes up to buffer.size() bytes
+    task<std::size_t> write_some(int fd, std::span<const std::byte> buffer) {
+        for (;;) {
+            const auto n = ::write(fd, buffer.data(), buffer.size());
+            if (n >= 0)
+                co_return static_cast<std::size_t>(n);
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                throw std::system_error(errno, std::system_category(), "write");
+            co_await writable(fd);
+        }
+    }
+
+    task<void> write_all(int fd, std::span<const std::byte> buffer) {
+        while (!buffer.empty()) {
+            buffer = buffer.subspan(co_await write_some(fd, buffer));
+        }
+    }
+
+    // Runs t concurrently with the other tasks of the loop.
+    // Exceptions escaping t are rethrown by run().
+    void spawn(task<void> t) {
+        m_ready.push_back(t.m_coroutine);
+        m_spawned.push_back(std::move(t));
+    }
+
+    // Runs the loop until t completes, returns its result
+    template <typename T>
+    T run(task<T> t) {
+        m_ready.push_back(t.m_coroutine);
+        while (!t.is_ready()) {
+            if (!run_once())
+                throw std::logic_error("event_loop: the task is waiting but nothing is pending");
+        }
+        return t.m_coroutine.promise().result();
+    }
+
+    // Runs the loop until no work is pending
+    void run() {
+        while (run_once()) {
+        }
+    }
+
+    // Waits for and resumes the coroutines which are ready,
+    // returns false if there is nothing to wait for.
+    bool run_once() {
+        reap();
+        if (m_ready.empty() && m_timers.empty() && m_waiting == 0)
+            return false;
+
+        int timeout = -1;
+        if (!m_ready.empty()) {
+            timeout = 0;
+        } else if (!m_timers.empty()) {
+            const auto deadline = m_timers.begin()->deadline;
+            const auto now = clock::now();
+            timeout = deadline <= now ? 0 : static_cast<int>(std::min<std::int64_t>(
+                std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count(), INT_MAX));
+        }
+
+        epoll_event events[64];
+        const int n = ::epoll_wait(m_epoll, events, 64, timeout);
+        if (n < 0 && errno != EINTR)
+            throw std::system_error(errno, std::system_category(), "epoll_wait");
+        for (int i = 0; i < n; ++i)
+            dispatch(events[i].data.fd, events[i].events);
+
+        const auto now = clock::now();
+        while (!m_timers.empty() && m_timers.begin()->deadline <= now) {
+            m_ready.push_back(m_timers.begin()->coroutine);
+            m_timers.erase(m_timers.begin());
+        }
+
+        // coroutines scheduled while resuming will run on the next iteration;
+        // coroutines destroyed while resuming are reset by cancel()
+        m_resuming = std::exchange(m_ready, {});
+        for (std::size_t i = 0; i < m_resuming.size(); ++i) {
+            if (auto coroutine = std::exchange(m_resuming[i], nullptr))
+                coroutine.resume();
+        }
+        m_resuming.clear();
+
+        reap();
+        return true;
+    }
+
+  private:
+    // The coroutines waiting on a file descriptor, which is registered
+    // for the events they wait for
+    struct fd_waiters {
+        std::coroutine_handle<> reader = nullptr;
+        std::coroutine_handle<> writer = nullptr;
+        bool registered = false;
+
+        std::coroutine_handle<> &waiter(std::uint32_t events) noexcept {
+            return events == EPOLLIN ? reader : writer;
+        }
+    };
+
+    struct io_awaiter {
+        event_loop &loop;
+        int fd;
+        std::uint32_t events;
+        // The suspended coroutine, until it is resumed
+        std::coroutine_handle<> suspended = nullptr;
+
+        io_awaiter(event_loop &loop, int fd, std::uint32_t events) noexcept : loop(loop), fd(fd), events(events) {
+        }
+
+        io_awaiter(const io_awaiter &) = delete;
+
+        // Destroyed while suspended, when the coroutine is destroyed
+        ~io_awaiter() {
+            if (suspended)
+                loop.cancel(fd, events, suspended);
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            auto &w = loop.m_fds[fd];
+            auto &waiter = w.waiter(events);
+            if (waiter)
+                throw std::logic_error("event_loop: the file descriptor is already awaited in this direction");
+            waiter = h;
+            try {
+                loop.update(fd, w);
+            } catch (...) {
+                waiter = nullptr;
+                if (!w.reader && !w.writer)
+                    loop.m_fds.erase(fd);
+                throw;
+            }
+            suspended = h;
+            ++loop.m_waiting;
+        }
+
+        void await_resume() noexcept {
+            suspended = nullptr;
+        }
+    };
+
+    // Registers fd for the events its waiters wait for,
+    // deregisters it once it has no waiter
+    void update(int fd, fd_waiters &w) {
+        const std::uint32_t events = (w.reader ? std::uint32_t(EPOLLIN) : 0) | (w.writer ? std::uint32_t(EPOLLOUT) : 0);
+        if (!events) {
+            // fails if fd was already closed, which deregistered it
+            if (w.registered)
+                ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+            m_fds.erase(fd);
+            return;
+        }
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        if (::epoll_ctl(m_epoll, w.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) < 0)
+            throw std::system_error(errno, std::system_category(), "epoll_ctl");
+        w.registered = true;
+    }
+
+    // Schedules the waiters of fd concerned by events.
+    // Errors and hang ups resume both, whose next read or write reports them.
+    void dispatch(int fd, std::uint32_t events) {
+        const auto it = m_fds.find(fd);
+        if (it == m_fds.end())
+            return;
+        auto &w = it->second;
+        const bool failed = events & (EPOLLERR | EPOLLHUP);
+        if (w.reader && (failed || (events & EPOLLIN))) {
+            m_ready.push_back(std::exchange(w.reader, nullptr));
+            --m_waiting;
+        }
+        if (w.writer && (failed || (events & EPOLLOUT))) {
+            m_ready.push_back(std::exchange(w.writer, nullptr));
+            --m_waiting;
+        }
+        update(fd, w);
+    }
+
+    // Forgets h, destroyed while waiting on fd, or scheduled to be resumed
+    void cancel(int fd, std::uint32_t events, std::coroutine_handle<> h) noexcept {
+        if (const auto it = m_fds.find(fd); it != m_fds.end() && it->second.waiter(events) == h) {
+            it->second.waiter(events) = nullptr;
+            --m_waiting;
+            try {
+                update(fd, it->second);
+            } catch (...) {
+                // A failed EPOLL_CTL_MOD leaves the other waiter registered for both
+                // events; a spurious wake up of the removed direction is ignored by dispatch
+            }
+            return;
+        }
+        unschedule(h);
+    }
+
+    // Forgets h, destroyed after being scheduled to be resumed
+    void unschedule(std::coroutine_handle<> h) noexcept {
+        std::replace(m_ready.begin(), m_ready.end(), h, std::coroutine_handle<>());
+        std::replace(m_resuming.begin(), m_resuming.end(), h, std::coroutine_handle<>());
+    }
+
+    struct timer {
+        clock::time_point deadline;
+        std::uint64_t sequence;
+        std::coroutine_handle<> coroutine;
+
+        bool operator<(const timer &other) const noexcept {
+            if (deadline != other.deadline)
+                return deadline < other.deadline;
+            return sequence < other.sequence;
+        }
+    };
+
+    struct timer_awaiter {
+        event_loop &loop;
+        clock::time_point deadline;
+        // The timer of the suspended coroutine, until it is resumed
+        std::optional<timer> pending;
+
+        timer_awaiter(event_loop &loop, clock::time_point deadline) noexcept : loop(loop), deadline(deadline) {
+        }
+
+        timer_awaiter(const timer_awaiter &) = delete;
+
+        // Destroyed while suspended, when the coroutine is destroyed
+        ~timer_awaiter() {
+            if (pending && !loop.m_timers.erase(*pending))
+                loop.unschedule(pending->coroutine);
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            const timer t{deadline, loop.m_timer_sequence++, h};
+            loop.m_timers.insert(t);
+            pending = t;
+        }
+
+        void await_resume() noexcept {
+            pending.reset();
+        }
+    };
+
+    // Destroys completed spawned tasks, rethrowing their exceptions
+    void reap() {
+        for (auto it = m_spawned.begin(); it != m_spawned.end();) {
+            if (!it->is_ready()) {
+                ++it;
+                continue;
+            }
+            auto t = std::move(*it);
+            it = m_spawned.erase(it);
+            t.m_coroutine.promise().result();
+        }
+    }
+
+    int m_epoll = -1;
+    std::size_t m_waiting = 0;
+    std::uint64_t m_timer_sequence = 0;
+    std::vector<std::coroutine_handle<>> m_ready;
+    std::vector<std::coroutine_handle<>> m_resuming;
+    std::unordered_map<int, fd_waiters> m_fds;
+    // Ordered by deadline, then by scheduling order
+    std::set<timer> m_timers;
+    std::list<task<void>> m_spawned;
+};
+
+} // namespace cor3ntin::rangesnext
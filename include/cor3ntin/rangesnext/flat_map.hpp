@@ -0,0 +1,482 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cor3ntin/rangesnext/to.hpp>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cor3ntin::rangesnext {
+
+namespace detail {
+
+struct identity_key {
+    template <typename T>
+    constexpr const T &operator()(const T &value) const noexcept {
+        return value;
+    }
+};
+
+struct first_key {
+    template <typename P>
+    constexpr const auto &operator()(const P &value) const noexcept {
+        return value.first;
+    }
+};
+
+// A sorted vector of unique keys, the common implementation of flat_set and flat_map.
+// Ranges are inserted at the end of the vector, sorted and merged at once.
+template <typename Key, typename Value, typename KeyOf, typename Compare, typename Container>
+class flat_tree {
+  public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_compare = Compare;
+    using container_type = Container;
+    using size_type = typename Container::size_type;
+    using difference_type = typename Container::difference_type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    // The keys of a set can't be modified in place
+    using iterator = std::conditional_t<std::same_as<Key, Value>, typename Container::const_iterator,
+                                        typename Container::iterator>;
+    using const_iterator = typename Container::const_iterator;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    flat_tree() = default;
+
+    explicit flat_tree(const Compare &comp) : m_comp(comp) {
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    flat_tree(It first, S last, const Compare &comp = Compare()) : m_comp(comp) {
+        insert(std::move(first), std::move(last));
+    }
+
+    template <std::ranges::input_range R>
+    requires std::constructible_from<Value, std::ranges::range_reference_t<R>>
+    flat_tree(from_range_t, R &&rng, const Compare &comp = Compare()) : m_comp(comp) {
+        insert(std::ranges::begin(rng), std::ranges::end(rng));
+    }
+
+    flat_tree(std::initializer_list<Value> values, const Compare &comp = Compare())
+        : flat_tree(values.begin(), values.end(), comp) {
+    }
+
+    // cont must be sorted, without duplicates
+    flat_tree(sorted_unique_t, Container cont, const Compare &comp = Compare())
+        : m_data(std::move(cont)), m_comp(comp) {
+        assert(is_sorted_unique(m_data.begin(), m_data.end()) && "flat_tree: the container is not sorted_unique");
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    flat_tree(sorted_unique_t, It first, S last, const Compare &comp = Compare()) : m_comp(comp) {
+        append(std::move(first), std::move(last));
+        assert(is_sorted_unique(m_data.begin(), m_data.end()) && "flat_tree: the range is not sorted_unique");
+    }
+
+    iterator begin() noexcept {
+        return m_data.begin();
+    }
+    const_iterator begin() const noexcept {
+        return m_data.begin();
+    }
+    const_iterator cbegin() const noexcept {
+        return m_data.begin();
+    }
+    iterator end() noexcept {
+        return m_data.end();
+    }
+    const_iterator end() const noexcept {
+        return m_data.end();
+    }
+    const_iterator cend() const noexcept {
+        return m_data.end();
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    bool empty() const noexcept {
+        return m_data.empty();
+    }
+    size_type size() const noexcept {
+        return m_data.size();
+    }
+    size_type max_size() const noexcept {
+        return m_data.max_size();
+    }
+    size_type capacity() const noexcept {
+        return m_data.capacity();
+    }
+    void reserve(size_type n) {
+        m_data.reserve(n);
+    }
+    void shrink_to_fit() {
+        m_data.shrink_to_fit();
+    }
+    void clear() noexcept {
+        m_data.clear();
+    }
+
+    key_compare key_comp() const {
+        return m_comp;
+    }
+
+    iterator find(const Key &key) {
+        auto it = lower_bound(key);
+        return it != end() && !m_comp(key, KeyOf{}(*it)) ? it : end();
+    }
+    const_iterator find(const Key &key) const {
+        auto it = lower_bound(key);
+        return it != end() && !m_comp(key, KeyOf{}(*it)) ? it : end();
+    }
+    bool contains(const Key &key) const {
+        return find(key) != end();
+    }
+    size_type count(const Key &key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    iterator lower_bound(const Key &key) {
+        return std::ranges::lower_bound(m_data, key, m_comp, KeyOf{});
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return std::ranges::lower_bound(m_data, key, m_comp, KeyOf{});
+    }
+    iterator upper_bound(const Key &key) {
+        return std::ranges::upper_bound(m_data, key, m_comp, KeyOf{});
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return std::ranges::upper_bound(m_data, key, m_comp, KeyOf{});
+    }
+    std::pair<iterator, iterator> equal_range(const Key &key) {
+        auto it = lower_bound(key);
+        return {it, it != end() && !m_comp(key, KeyOf{}(*it)) ? std::next(it) : it};
+    }
+    std::pair<const_iterator, const_iterator> equal_range(const Key &key) const {
+        auto it = lower_bound(key);
+        return {it, it != end() && !m_comp(key, KeyOf{}(*it)) ? std::next(it) : it};
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return insert_unique(value);
+    }
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return insert_unique(std::move(value));
+    }
+
+    // Constant time (amortized) when value belongs right before hint,
+    // so sorted input is inserted in linear time
+    iterator insert(const_iterator hint, const value_type &value) {
+        return insert_hint(hint, value);
+    }
+    iterator insert(const_iterator hint, value_type &&value) {
+        return insert_hint(hint, std::move(value));
+    }
+
+    // Appends [first, last), then sorts and merges the new elements
+    // with the existing ones. Equivalent elements already in the
+    // container, or appearing earlier in the range, are kept.
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void insert(It first, S last) {
+        const auto old_size = m_data.size();
+        append(std::move(first), std::move(last));
+        sort_unique(old_size);
+    }
+
+    template <std::ranges::input_range R>
+    void insert_range(R &&rng) {
+        insert(std::ranges::begin(rng), std::ranges::end(rng));
+    }
+
+    void insert(std::initializer_list<value_type> values) {
+        insert(values.begin(), values.end());
+    }
+
+    // [first, last) must be sorted, without duplicates
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void insert(sorted_unique_t, It first, S last) {
+        const auto old_size = m_data.size();
+        append(std::move(first), std::move(last));
+        assert(is_sorted_unique(m_data.begin() + old_size, m_data.end()) &&
+               "flat_tree: the range is not sorted_unique");
+        merge_unique(old_size);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&...args) {
+        return insert_unique(value_type(std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    iterator emplace_hint(const_iterator hint, Args &&...args) {
+        return insert_hint(hint, value_type(std::forward<Args>(args)...));
+    }
+
+    iterator erase(iterator pos) {
+        return m_data.erase(pos);
+    }
+    iterator erase(const_iterator pos) requires(!std::same_as<iterator, const_iterator>) {
+        return m_data.erase(pos);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        return m_data.erase(first, last);
+    }
+    size_type erase(const Key &key) {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        m_data.erase(it);
+        return 1;
+    }
+
+    // Moves the underlying container out, leaving *this empty
+    container_type extract() && {
+        container_type res = std::move(m_data);
+        m_data.clear();
+        return res;
+    }
+
+    // cont must be sorted, without duplicates
+    void replace(container_type &&cont) {
+        m_data = std::move(cont);
+        assert(is_sorted_unique(m_data.begin(), m_data.end()) && "flat_tree: the container is not sorted_unique");
+    }
+
+    void swap(flat_tree &other) noexcept {
+        using std::swap;
+        swap(m_data, other.m_data);
+        swap(m_comp, other.m_comp);
+    }
+
+    friend bool operator==(const flat_tree &a, const flat_tree &b) {
+        return a.m_data == b.m_data;
+    }
+
+    friend auto operator<=>(const flat_tree &a, const flat_tree &b) {
+        return a.m_data <=> b.m_data;
+    }
+
+  protected:
+    template <typename V>
+    std::pair<iterator, bool> insert_unique(V &&value) {
+        auto it = lower_bound(KeyOf{}(value));
+        if (it != end() && !m_comp(KeyOf{}(value), KeyOf{}(*it)))
+            return {it, false};
+        return {m_data.insert(it, std::forward<V>(value)), true};
+    }
+
+  private:
+    template <typename V>
+    iterator insert_hint(const_iterator hint, V &&value) {
+        const auto &key = KeyOf{}(value);
+        if ((hint == m_data.cbegin() || m_comp(KeyOf{}(*std::prev(hint)), key)) &&
+            (hint == m_data.cend() || m_comp(key, KeyOf{}(*hint))))
+            return m_data.insert(hint, std::forward<V>(value));
+        return insert_unique(std::forward<V>(value)).first;
+    }
+
+    template <typename It, typename S>
+    void append(It first, S last) {
+        if constexpr (std::sized_sentinel_for<S, It>)
+            m_data.reserve(m_data.size() + static_cast<size_type>(last - first));
+        for (; first != last; ++first)
+            m_data.emplace_back(*first);
+    }
+
+    bool equivalent(const value_type &a, const value_type &b) const {
+        return !m_comp(KeyOf{}(a), KeyOf{}(b)) && !m_comp(KeyOf{}(b), KeyOf{}(a));
+    }
+
+    template <typename It>
+    bool is_sorted_unique(It first, It last) const {
+        return std::adjacent_find(first, last, [this](const auto &a, const auto &b) {
+                   return !m_comp(KeyOf{}(a), KeyOf{}(b));
+               }) == last;
+    }
+
+    // Sorts the elements after the first `sorted` ones, then merges them
+    // with the sorted prefix. Sorted input is detected and not sorted again.
+    void sort_unique(size_type sorted) {
+        const auto first = m_data.begin() + static_cast<difference_type>(sorted);
+        if (is_sorted_unique(first, m_data.end())) {
+            merge_unique(sorted);
+            return;
+        }
+        // stable, so that the first of equivalent elements is kept
+        std::stable_sort(first, m_data.end(),
+                         [this](const auto &a, const auto &b) { return m_comp(KeyOf{}(a), KeyOf{}(b)); });
+        m_data.erase(std::unique(first, m_data.end(), [this](const auto &a, const auto &b) { return equivalent(a, b); }),
+                     m_data.end());
+        merge_unique(sorted);
+    }
+
+    // Merges the sorted, unique elements after the first `sorted` ones
+    // with these, and removes the duplicates.
+    void merge_unique(size_type sorted) {
+        const auto first = m_data.begin() + static_cast<difference_type>(sorted);
+        if (sorted == 0 || first == m_data.end() || m_comp(KeyOf{}(*std::prev(first)), KeyOf{}(*first)))
+            return;
+        std::inplace_merge(m_data.begin(), first, m_data.end(),
+                           [this](const auto &a, const auto &b) { return m_comp(KeyOf{}(a), KeyOf{}(b)); });
+        m_data.erase(
+            std::unique(m_data.begin(), m_data.end(), [this](const auto &a, const auto &b) { return equivalent(a, b); }),
+            m_data.end());
+    }
+
+  protected:
+    Container m_data;
+    [[no_unique_address]] Compare m_comp;
+};
+
+template <typename It>
+using iter_key_t = std::remove_const_t<std::tuple_element_t<0, std::iter_value_t<It>>>;
+
+template <typename It>
+using iter_mapped_t = std::tuple_element_t<1, std::iter_value_t<It>>;
+
+template <typename R>
+using range_key_t = iter_key_t<std::ranges::iterator_t<R>>;
+
+template <typename R>
+using range_mapped_t = iter_mapped_t<std::ranges::iterator_t<R>>;
+
+} // namespace detail
+
+// A set stored as a sorted std::vector.
+// Lookups are binary searches over contiguous memory; inserting
+// a single element is linear, use the range constructors or insert(first, last).
+template <typename Key, typename Compare = std::less<Key>, typename Container = std::vector<Key>>
+class flat_set : public detail::flat_tree<Key, Key, detail::identity_key, Compare, Container> {
+    using base = detail::flat_tree<Key, Key, detail::identity_key, Compare, Container>;
+
+  public:
+    using value_compare = Compare;
+    using base::base;
+
+    value_compare value_comp() const {
+        return this->m_comp;
+    }
+
+    friend void swap(flat_set &a, flat_set &b) noexcept {
+        a.swap(b);
+    }
+};
+
+template <std::input_iterator It, typename Compare = std::less<std::iter_value_t<It>>>
+flat_set(It, It, Compare = Compare()) -> flat_set<std::iter_value_t<It>, Compare>;
+
+template <std::ranges::input_range R, typename Compare = std::less<std::ranges::range_value_t<R>>>
+flat_set(from_range_t, R &&, Compare = Compare()) -> flat_set<std::ranges::range_value_t<R>, Compare>;
+
+template <typename Key, typename Compare = std::less<Key>>
+flat_set(std::initializer_list<Key>, Compare = Compare()) -> flat_set<Key, Compare>;
+
+// A map stored as a sorted std::vector of pairs.
+// Like boost::container::flat_map, the keys of the elements
+// are mutable but must not be modified.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Container = std::vector<std::pair<Key, T>>>
+class flat_map : public detail::flat_tree<Key, std::pair<Key, T>, detail::first_key, Compare, Container> {
+    using base = detail::flat_tree<Key, std::pair<Key, T>, detail::first_key, Compare, Container>;
+
+  public:
+    using mapped_type = T;
+    using typename base::iterator;
+
+    struct value_compare {
+        bool operator()(const std::pair<Key, T> &a, const std::pair<Key, T> &b) const {
+            return comp(a.first, b.first);
+        }
+        [[no_unique_address]] Compare comp;
+    };
+
+    using base::base;
+
+    value_compare value_comp() const {
+        return {this->m_comp};
+    }
+
+    T &operator[](const Key &key) {
+        return try_emplace(key).first->second;
+    }
+
+    T &operator[](Key &&key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    T &at(const Key &key) {
+        auto it = this->find(key);
+        if (it == this->end())
+            throw std::out_of_range("flat_map::at");
+        return it->second;
+    }
+
+    const T &at(const Key &key) const {
+        auto it = this->find(key);
+        if (it == this->end())
+            throw std::out_of_range("flat_map::at");
+        return it->second;
+    }
+
+    template <typename K, typename... Args>
+    requires std::constructible_from<Key, K &&>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+        auto it = this->lower_bound(key);
+        if (it != this->end() && !this->m_comp(key, it->first))
+            return {it, false};
+        it = this->m_data.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                  std::forward_as_tuple(std::forward<Args>(args)...));
+        return {it, true};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, M &&value) {
+        auto res = try_emplace(key, std::forward<M>(value));
+        if (!res.second)
+            res.first->second = std::forward<M>(value);
+        return res;
+    }
+
+    friend void swap(flat_map &a, flat_map &b) noexcept {
+        a.swap(b);
+    }
+};
+
+template <std::input_iterator It, typename Compare = std::less<detail::iter_key_t<It>>>
+flat_map(It, It, Compare = Compare())
+    -> flat_map<detail::iter_key_t<It>, detail::iter_mapped_t<It>, Compare>;
+
+template <std::ranges::input_range R, typename Compare = std::less<detail::range_key_t<R>>>
+flat_map(from_range_t, R &&, Compare = Compare())
+    -> flat_map<detail::range_key_t<R>, detail::range_mapped_t<R>, Compare>;
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+flat_map(std::initializer_list<std::pair<Key, T>>, Compare = Compare()) -> flat_map<Key, T, Compare>;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,141 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+struct frame_pool_stats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t deallocations = 0;
+    // too large to be pooled
+    std::size_t oversized = 0;
+
+    constexpr double hit_rate() const {
+        const auto total = hits + misses;
+        return total ? double(hits) / double(total) : 0.0;
+    }
+};
+
+// A per-thread cache of freed memory blocks, bucketed by size.
+// Allocations are rounded up to a multiple of granularity;
+// blocks larger than max_size are not cached.
+// Memory freed on a thread is reused by allocations on that same thread.
+class frame_pool {
+  public:
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t max_size = 4096;
+
+    static void *allocate(std::size_t size) {
+        auto &s = local();
+        if (size > max_size) {
+            ++s.stats.oversized;
+            return ::operator new(size);
+        }
+        auto &head = s.free[bucket(size)];
+        if (head) {
+            ++s.stats.hits;
+            return std::exchange(head, head->next);
+        }
+        ++s.stats.misses;
+        return ::operator new((bucket(size) + 1) * granularity);
+    }
+
+    static void deallocate(void *ptr, std::size_t size) noexcept {
+        auto &s = local();
+        ++s.stats.deallocations;
+        if (size > max_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        auto &head = s.free[bucket(size)];
+        head = ::new (ptr) node{head};
+    }
+
+    // Statistics for the calling thread
+    static frame_pool_stats stats() noexcept {
+        return local().stats;
+    }
+
+    static void reset_stats() noexcept {
+        local().stats = {};
+    }
+
+    // Returns the blocks cached by the calling thread to the global heap
+    static void release() noexcept {
+        local().release();
+    }
+
+  private:
+    struct node {
+        node *next;
+    };
+
+    static constexpr std::size_t buckets = max_size / granularity;
+
+    struct state {
+        std::array<node *, buckets> free = {};
+        frame_pool_stats stats;
+
+        void release() noexcept {
+            for (auto &head : free) {
+                while (head) {
+                    ::operator delete(std::exchange(head, head->next));
+                }
+            }
+        }
+
+        ~state() {
+            release();
+        }
+    };
+
+    static constexpr std::size_t bucket(std::size_t size) {
+        return size ? (size - 1) / granularity : 0;
+    }
+
+    static state &local() noexcept {
+        thread_local state s;
+        return s;
+    }
+};
+
+// An allocator drawing from the per-thread frame_pool, for example
+// generator<int, int, recycling_frame_allocator<>>
+template <typename T = std::byte>
+struct recycling_frame_allocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    recycling_frame_allocator() = default;
+
+    template <typename U>
+    constexpr recycling_frame_allocator(const recycling_frame_allocator<U> &) noexcept {
+    }
+
+    T *allocate(std::size_t n) {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        return static_cast<T *>(frame_pool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept {
+        frame_pool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    friend constexpr bool operator==(const recycling_frame_allocator &, const recycling_frame_allocator<U> &) {
+        return true;
+    }
+};
+
+} // namespace cor3ntin::rangesnext
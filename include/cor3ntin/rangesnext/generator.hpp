@@ -12,47 +12,365 @@ See LICENSE.md for details.
 
 #pragma once
 
+#include <cassert>
+#include <concepts>
 #include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
 #include <ranges>
+#include <type_traits>
+#include <utility>
 
 namespace cor3ntin::rangesnext {
 
-template <typename YieldedType,
-          typename ValueType = std::remove_cvref_t<YieldedType>>
+namespace r = std::ranges;
+
+namespace detail {
+
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) frame_block {
+    unsigned char data[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+};
+
+template <typename Alloc>
+using frame_block_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<frame_block>;
+
+constexpr std::size_t align_frame_offset(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr std::size_t frame_blocks(std::size_t size) {
+    return (size + sizeof(frame_block) - 1) / sizeof(frame_block);
+}
+
+// Allocates coroutine frames with an allocator of type Alloc,
+// default constructed or passed to the coroutine as
+// (std::allocator_arg, alloc, args...).
+// Stateful allocators are stored after the frame.
+template <typename Alloc>
+class frame_allocator_base {
+    using block_alloc = frame_block_allocator<Alloc>;
+    using traits = std::allocator_traits<block_alloc>;
+
+    static constexpr bool stateless =
+        std::default_initializable<block_alloc> && traits::is_always_equal::value;
+
+    static constexpr std::size_t allocator_offset(std::size_t size) {
+        return align_frame_offset(size, alignof(block_alloc));
+    }
+
+    static constexpr std::size_t blocks(std::size_t size) {
+        if constexpr (stateless)
+            return frame_blocks(size);
+        else
+            return frame_blocks(allocator_offset(size) + sizeof(block_alloc));
+    }
+
+    static void *allocate(block_alloc alloc, std::size_t size) {
+        void *ptr = std::to_address(traits::allocate(alloc, blocks(size)));
+        if constexpr (!stateless) {
+            ::new (static_cast<char *>(ptr) + allocator_offset(size)) block_alloc(std::move(alloc));
+        }
+        return ptr;
+    }
+
+  public:
+    static void *operator new(std::size_t size) requires std::default_initializable<block_alloc> {
+        return allocate(block_alloc(), size);
+    }
+
+    template <typename A, typename... Args>
+    requires std::convertible_to<const A &, Alloc>
+    static void *operator new(std::size_t size, std::allocator_arg_t, const A &alloc, const Args &...) {
+        return allocate(block_alloc(static_cast<Alloc>(alloc)), size);
+    }
+
+    // member functions and lambdas
+    template <typename This, typename A, typename... Args>
+    requires std::convertible_to<const A &, Alloc>
+    static void *operator new(std::size_t size, const This &, std::allocator_arg_t, const A &alloc,
+                              const Args &...) {
+        return allocate(block_alloc(static_cast<Alloc>(alloc)), size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size) noexcept {
+        auto *frame = static_cast<frame_block *>(ptr);
+        if constexpr (stateless) {
+            block_alloc alloc;
+            traits::deallocate(alloc, frame, blocks(size));
+        } else {
+            auto *stored =
+                std::launder(reinterpret_cast<block_alloc *>(static_cast<char *>(ptr) + allocator_offset(size)));
+            block_alloc alloc(std::move(*stored));
+            stored->~block_alloc();
+            traits::deallocate(alloc, frame, blocks(size));
+        }
+    }
+};
+
+// The default: frames are allocated with the global operator new.
+// Coroutines taking (std::allocator_arg, alloc, args...) get a promise
+// using an erased_frame_allocator instead, so that only their frames
+// store how to deallocate them.
+template <>
+class frame_allocator_base<void> {
+  public:
+    static void *operator new(std::size_t size) {
+        return ::operator new(size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size) noexcept {
+        ::operator delete(ptr, size);
+    }
+};
+
+// Type-erased: any allocator can be passed to the coroutine.
+// A deallocation function, followed by the allocator if it is stateful,
+// is stored after the frame.
+class erased_frame_allocator {
+    using deallocate_fn = void (*)(void *, std::size_t);
+
+    static constexpr std::size_t function_offset(std::size_t size) {
+        return align_frame_offset(size, alignof(deallocate_fn));
+    }
+
+    template <typename Alloc>
+    static constexpr bool stateless = std::default_initializable<Alloc> &&std::is_empty_v<Alloc>;
+
+    template <typename Alloc>
+    static constexpr std::size_t allocator_offset(std::size_t size) {
+        return align_frame_offset(function_offset(size) + sizeof(deallocate_fn), alignof(Alloc));
+    }
+
+    template <typename Alloc>
+    static constexpr std::size_t blocks(std::size_t size) {
+        if constexpr (stateless<Alloc>)
+            return frame_blocks(function_offset(size) + sizeof(deallocate_fn));
+        else
+            return frame_blocks(allocator_offset<Alloc>(size) + sizeof(Alloc));
+    }
+
+    template <typename A>
+    static void *allocate(const A &a, std::size_t size) {
+        using block_alloc = frame_block_allocator<A>;
+        using traits = std::allocator_traits<block_alloc>;
+
+        block_alloc alloc(a);
+        void *ptr = std::to_address(traits::allocate(alloc, blocks<block_alloc>(size)));
+        auto *bytes = static_cast<char *>(ptr);
+
+        deallocate_fn fn = [](void *ptr, std::size_t size) {
+            auto *frame = static_cast<frame_block *>(ptr);
+            if constexpr (stateless<block_alloc>) {
+                block_alloc alloc;
+                traits::deallocate(alloc, frame, blocks<block_alloc>(size));
+            } else {
+                auto *stored = std::launder(
+                    reinterpret_cast<block_alloc *>(static_cast<char *>(ptr) + allocator_offset<block_alloc>(size)));
+                block_alloc alloc(std::move(*stored));
+                stored->~block_alloc();
+                traits::deallocate(alloc, frame, blocks<block_alloc>(size));
+            }
+        };
+        ::new (bytes + function_offset(size)) deallocate_fn(fn);
+        if constexpr (!stateless<block_alloc>) {
+            ::new (bytes + allocator_offset<block_alloc>(size)) block_alloc(std::move(alloc));
+        }
+        return ptr;
+    }
+
+  public:
+    template <typename A, typename... Args>
+    static void *operator new(std::size_t size, std::allocator_arg_t, const A &alloc, const Args &...) {
+        return allocate(alloc, size);
+    }
+
+    // member functions and lambdas
+    template <typename This, typename A, typename... Args>
+    static void *operator new(std::size_t size, const This &, std::allocator_arg_t, const A &alloc,
+                              const Args &...) {
+        return allocate(alloc, size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size) noexcept {
+        auto fn = *std::launder(reinterpret_cast<deallocate_fn *>(static_cast<char *>(ptr) + function_offset(size)));
+        fn(ptr, size);
+    }
+};
+
+// Whether the parameters of a coroutine start with (std::allocator_arg, alloc),
+// possibly after the object of a member function
+template <typename First = void, typename Second = void, typename Third = void, typename... Rest>
+constexpr bool takes_allocator_arg =
+    (std::same_as<std::remove_cvref_t<First>, std::allocator_arg_t> && !std::is_void_v<Second>) ||
+    (std::same_as<std::remove_cvref_t<Second>, std::allocator_arg_t> && !std::is_void_v<Third>);
+
+} // namespace detail
+
+// Yielding elements_of(rng) from a generator yields each element of rng.
+// When rng is a generator of the same type, its coroutine
+// is resumed directly, instead of through the outer generator.
+template <r::range R, typename Alloc = std::allocator<std::byte>>
+struct elements_of {
+    [[no_unique_address]] R range;
+    [[no_unique_address]] Alloc allocator = Alloc();
+};
+
+template <typename R, typename Alloc = std::allocator<std::byte>>
+elements_of(R &&, Alloc = Alloc()) -> elements_of<R &&, Alloc>;
+
+// Yielded by a generator before its first element, or passed as a parameter
+// of the coroutine, announces how many elements it is going to produce.
+// size_hint is an estimate, exact_size is checked in debug builds.
+struct size_hint {
+    std::size_t value;
+};
+
+struct exact_size {
+    std::size_t value;
+};
+
+// The default instrumentation policy of generator, which does nothing.
+// A policy is notified of the frame allocations and yields of each generator
+// type G, and resumes its coroutines.
+// See instrumentation.hpp for a policy collecting statistics.
+struct no_instrumentation {
+    template <typename G>
+    static void on_allocate(std::size_t) noexcept {
+    }
+
+    template <typename G>
+    static void on_deallocate(std::size_t) noexcept {
+    }
+
+    template <typename G>
+    static void on_yield() noexcept {
+    }
+
+    template <typename G>
+    static void resume(std::coroutine_handle<> coroutine) {
+        coroutine.resume();
+    }
+};
+
+// generator<T&&> produces rvalue references, from which the consumer can move.
+// Yielded rvalues are referenced in place, yielded lvalues are copied
+// into a slot of the promise first.
+//
+// When Allocator is void, coroutine frames are allocated with the allocator
+// passed as (std::allocator_arg, alloc, args...) if any, which is type-erased
+// in the frame, with the global operator new otherwise.
+// Otherwise, frames are allocated with an Allocator, which can be
+// passed to the coroutine the same way.
+//
+// Instrumentation is a policy such as no_instrumentation.
+template <typename YieldedType, typename ValueType = std::remove_cvref_t<YieldedType>, typename Allocator = void,
+          typename Instrumentation = no_instrumentation>
 class [[nodiscard]] generator {
-    class promise {
+    static constexpr bool yields_rvalues = std::is_rvalue_reference_v<YieldedType>;
+
+    using frame_allocator = detail::frame_allocator_base<Allocator>;
+
+    class promise : public frame_allocator {
       public:
+        template <typename... Args>
+        requires requires(std::size_t size, Args &&...args) {
+            frame_allocator::operator new(size, std::forward<Args>(args)...);
+        }
+        static void *operator new(std::size_t size, Args &&...args) {
+            void *ptr = frame_allocator::operator new(size, std::forward<Args>(args)...);
+            Instrumentation::template on_allocate<generator>(size);
+            return ptr;
+        }
+
+        static void operator delete(void *ptr, std::size_t size) noexcept {
+            Instrumentation::template on_deallocate<generator>(size);
+            frame_allocator::operator delete(ptr, size);
+        }
+
         using value_type = ValueType;
-        using reference = std::add_lvalue_reference_t<YieldedType>;
+        using reference = std::conditional_t<yields_rvalues, YieldedType, std::add_lvalue_reference_t<YieldedType>>;
         using pointer = std::add_pointer_t<reference>;
 
+        promise() = default;
+
+        template <typename... Args>
+        promise(const Args &...args) noexcept {
+            (set_size(args), ...);
+        }
+
         auto get_return_object() noexcept {
-            return generator{
-                std::coroutine_handle<promise_type>::from_promise(*this)};
+            m_leaf = std::coroutine_handle<promise>::from_promise(*this);
+            return generator{m_leaf};
         }
 
         std::suspend_always initial_suspend() const noexcept {
             return {};
         }
 
-        std::suspend_always final_suspend() const noexcept {
-            return {};
+        // A nested generator resumes its parent when it completes
+        auto final_suspend() const noexcept {
+            return final_awaiter{};
         }
 
         std::suspend_always
         yield_value(std::remove_reference_t<reference> &&value) noexcept {
-            m_value = std::addressof(value);
+            m_root->m_value = std::addressof(value);
+            count_yield();
             return {};
         }
 
         std::suspend_always
-        yield_value(std::remove_reference_t<reference> &value) noexcept {
-            m_value = std::addressof(value);
+        yield_value(std::remove_reference_t<reference> &value) noexcept requires(!yields_rvalues) {
+            m_root->m_value = std::addressof(value);
+            count_yield();
             return {};
         }
 
+        // The consumer may move from the value, so lvalues are copied first
+        std::suspend_always yield_value(const std::remove_reference_t<reference> &value) requires yields_rvalues &&
+            std::copy_constructible<std::remove_cvref_t<reference>> {
+            m_root->m_value = std::addressof(m_slot.emplace(value));
+            count_yield();
+            return {};
+        }
+
+        std::suspend_never yield_value(rangesnext::size_hint hint) noexcept {
+            set_size(hint);
+            return {};
+        }
+
+        std::suspend_never yield_value(rangesnext::exact_size size) noexcept {
+            set_size(size);
+            return {};
+        }
+
+        template <typename Alloc>
+        auto yield_value(elements_of<generator &&, Alloc> nested) noexcept {
+            return nested_awaiter{std::move(nested.range)};
+        }
+
+        template <typename R, typename Alloc>
+        requires std::convertible_to<r::range_reference_t<R>, reference> ||
+            (yields_rvalues && std::convertible_to<r::range_reference_t<R>, const std::remove_reference_t<reference> &>)
+        auto yield_value(elements_of<R, Alloc> nested) {
+            auto g = [](std::allocator_arg_t, Alloc, r::views::all_t<R> rng) -> generator {
+                for (auto &&e : rng) {
+                    if constexpr (std::convertible_to<r::range_reference_t<R>, reference>)
+                        co_yield static_cast<reference>(std::forward<decltype(e)>(e));
+                    else
+                        co_yield static_cast<const std::remove_reference_t<reference> &>(e);
+                }
+            };
+            return nested_awaiter{
+                g(std::allocator_arg, nested.allocator, r::views::all(std::forward<R>(nested.range)))};
+        }
+
         reference value() const noexcept {
-            return *m_value;
+            return static_cast<reference>(*m_value);
         }
 
         // Don't allow any use of 'co_await' inside the generator coroutine.
@@ -60,17 +378,131 @@ class [[nodiscard]] generator {
         std::suspend_never await_transform(U &&value) = delete;
 
         void return_void() noexcept {
+            assert((m_announced != announced::exact || m_parent || m_remaining == 0) &&
+                   "the generator did not yield the announced exact_size");
         }
 
+        // Exceptions escaping a nested generator are rethrown in its parent
         void unhandled_exception() {
-            throw;
+            if (!m_parent)
+                throw;
+            m_exception = std::current_exception();
         }
 
       private:
-        pointer m_value;
+        void set_size(rangesnext::size_hint hint) noexcept {
+            m_size_hint = hint.value;
+            m_announced = announced::hint;
+        }
+
+        void set_size(rangesnext::exact_size size) noexcept {
+            m_size_hint = m_remaining = size.value;
+            m_announced = announced::exact;
+        }
+
+        std::optional<std::size_t> announced_size() const noexcept {
+            if (m_announced == announced::none)
+                return std::nullopt;
+            return m_size_hint;
+        }
+
+        template <typename T>
+        void set_size(const T &) noexcept {
+        }
+
+        void count_yield() noexcept {
+            Instrumentation::template on_yield<generator>();
+            if (m_root->m_announced == announced::exact)
+                --m_root->m_remaining;
+        }
+
+        // P is erased_allocator_promise for coroutines taking an allocator_arg,
+        // the generator then holds a handle to its promise base
+        struct final_awaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+                promise &p = h.promise();
+                if (!p.m_parent)
+                    return std::noop_coroutine();
+                p.m_root->m_leaf = p.m_parent;
+                return p.m_parent;
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        struct nested_awaiter {
+            generator gen;
+
+            bool await_ready() const noexcept {
+                return !gen.m_coroutine;
+            }
+
+            template <typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+                promise &parent = h.promise();
+                auto &nested = gen.m_coroutine.promise();
+                nested.m_root = parent.m_root;
+                nested.m_parent = std::coroutine_handle<promise>::from_promise(parent);
+                parent.m_root->m_leaf = gen.m_coroutine;
+                return gen.m_coroutine;
+            }
+
+            void await_resume() {
+                if (gen.m_coroutine && gen.m_coroutine.promise().m_exception)
+                    std::rethrow_exception(std::move(gen.m_coroutine.promise().m_exception));
+            }
+        };
+
+        struct no_slot {};
+
+        enum class announced : unsigned char { none, hint, exact };
+
+        pointer m_value = nullptr;
+        // Holds copies of the yielded lvalues, for generators of rvalues
+        [[no_unique_address]] std::conditional_t<yields_rvalues, std::optional<std::remove_cvref_t<YieldedType>>, no_slot> m_slot;
+        // The outermost generator, which holds the current value
+        promise *m_root = this;
+        // The generator yielding elements_of this one, if any
+        std::coroutine_handle<promise> m_parent = nullptr;
+        // In the root, the innermost generator, to be resumed next
+        std::coroutine_handle<promise> m_leaf = nullptr;
+        std::exception_ptr m_exception = nullptr;
+        std::size_t m_size_hint = 0;
+        // The elements still to be yielded, only counted after an exact_size.
+        // Present in all builds, so that the layout of the promise doesn't depend on NDEBUG
+        std::size_t m_remaining = 0;
+        announced m_announced = announced::none;
         friend generator;
     };
 
+    // With a void Allocator, the promise of coroutines taking
+    // (std::allocator_arg, alloc, args...), selected by coroutine_traits
+    class erased_allocator_promise : public promise {
+      public:
+        using promise::promise;
+
+        template <typename... Args>
+        requires requires(std::size_t size, Args &&...args) {
+            detail::erased_frame_allocator::operator new(size, std::forward<Args>(args)...);
+        }
+        static void *operator new(std::size_t size, Args &&...args) {
+            void *ptr = detail::erased_frame_allocator::operator new(size, std::forward<Args>(args)...);
+            Instrumentation::template on_allocate<generator>(size);
+            return ptr;
+        }
+
+        static void operator delete(void *ptr, std::size_t size) noexcept {
+            Instrumentation::template on_deallocate<generator>(size);
+            detail::erased_frame_allocator::operator delete(ptr, size);
+        }
+    };
+
     struct sentinel {};
 
     class iterator {
@@ -108,7 +540,7 @@ class [[nodiscard]] generator {
         }
 
         iterator &operator++() {
-            m_coroutine.resume();
+            Instrumentation::template resume<generator>(m_coroutine.promise().m_leaf);
             return *this;
         }
         void operator++(int) {
@@ -130,11 +562,12 @@ class [[nodiscard]] generator {
 
   public:
     using promise_type = promise;
+    using allocator_arg_promise_type = erased_allocator_promise;
 
     generator() = default;
 
     generator(generator && other) noexcept
-        : m_coroutine(exchange(other.m_coroutine, nullptr)) {
+        : m_coroutine(std::exchange(other.m_coroutine, nullptr)), m_started(std::exchange(other.m_started, false)) {
     }
 
     generator(const generator &other) = delete;
@@ -151,16 +584,34 @@ class [[nodiscard]] generator {
     }
 
     auto begin() {
-        m_coroutine.resume();
+        if (!std::exchange(m_started, false))
+            Instrumentation::template resume<generator>(m_coroutine);
         return iterator{std::exchange(m_coroutine, nullptr)};
     }
 
+    // The number of elements announced by the coroutine, if any.
+    // Unless it was passed as a parameter of the coroutine, this runs the
+    // coroutine up to its first element, before begin() is called: the side
+    // effects of that code happen here, and its exceptions propagate from here.
+    std::optional<std::size_t> size_hint() {
+        if (!m_coroutine)
+            return std::nullopt;
+        auto &p = m_coroutine.promise();
+        if (p.m_announced == promise::announced::none && !m_started) {
+            // set first: if the coroutine throws, it is done, and begin() must not resume it
+            m_started = true;
+            Instrumentation::template resume<generator>(m_coroutine);
+        }
+        return p.announced_size();
+    }
+
     auto end() const noexcept {
         return sentinel{};
     }
 
     void swap(generator & other) noexcept {
         std::swap(m_coroutine, other.m_coroutine);
+        std::swap(m_started, other.m_started);
     }
 
   private:
@@ -169,14 +620,29 @@ class [[nodiscard]] generator {
     }
 
     std::coroutine_handle<promise> m_coroutine = nullptr;
+    // Whether size_hint() already ran the coroutine up to its first element
+    bool m_started = false;
 };
 
+namespace pmr {
+
+template <typename YieldedType, typename ValueType = std::remove_cvref_t<YieldedType>>
+using generator = rangesnext::generator<YieldedType, ValueType, std::pmr::polymorphic_allocator<>>;
+
+} // namespace pmr
+
 } // namespace cor3ntin::rangesnext
 
 namespace std {
 
-template <typename T, typename U>
+template <typename T, typename U, typename A, typename I>
 inline constexpr bool
-    ranges::enable_view<cor3ntin::rangesnext::generator<T, U>> = true;
+    ranges::enable_view<cor3ntin::rangesnext::generator<T, U, A, I>> = true;
+
+template <typename T, typename U, typename I, typename... Args>
+requires cor3ntin::rangesnext::detail::takes_allocator_arg<Args...>
+struct coroutine_traits<cor3ntin::rangesnext::generator<T, U, void, I>, Args...> {
+    using promise_type = typename cor3ntin::rangesnext::generator<T, U, void, I>::allocator_arg_promise_type;
+};
 
 }
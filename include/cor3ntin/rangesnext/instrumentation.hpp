@@ -0,0 +1,190 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cor3ntin::rangesnext {
+
+// A snapshot of the statistics of a generator type
+struct generator_stats {
+    std::string name;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t frame_bytes = 0;
+    std::uint64_t resumes = 0;
+    std::uint64_t yields = 0;
+    // time spent running the coroutine, including nested generators
+    std::chrono::nanoseconds time{0};
+};
+
+// Statistics of a generator type, updated by generator_instrumentation
+struct generator_counters {
+    std::atomic<std::uint64_t> allocations = 0;
+    std::atomic<std::uint64_t> deallocations = 0;
+    std::atomic<std::uint64_t> frame_bytes = 0;
+    std::atomic<std::uint64_t> resumes = 0;
+    std::atomic<std::uint64_t> yields = 0;
+    std::atomic<std::uint64_t> nanoseconds = 0;
+
+    void reset() noexcept {
+        for (auto *c : {&allocations, &deallocations, &frame_bytes, &resumes, &yields, &nanoseconds})
+            c->store(0, std::memory_order_relaxed);
+    }
+};
+
+// The counters of all the instrumented generator types, by name
+class instrumentation_registry {
+  public:
+    static instrumentation_registry &instance() {
+        static instrumentation_registry registry;
+        return registry;
+    }
+
+    // The counters are never destroyed, the reference stays valid
+    generator_counters &counters(std::string_view name) {
+        std::scoped_lock lock(m_mutex);
+        auto &c = m_counters[std::string(name)];
+        if (!c)
+            c = std::make_unique<generator_counters>();
+        return *c;
+    }
+
+    std::vector<generator_stats> snapshot() const {
+        std::scoped_lock lock(m_mutex);
+        std::vector<generator_stats> res;
+        res.reserve(m_counters.size());
+        for (const auto &[name, c] : m_counters) {
+            res.push_back({name, c->allocations.load(std::memory_order_relaxed),
+                           c->deallocations.load(std::memory_order_relaxed),
+                           c->frame_bytes.load(std::memory_order_relaxed), c->resumes.load(std::memory_order_relaxed),
+                           c->yields.load(std::memory_order_relaxed),
+                           std::chrono::nanoseconds(c->nanoseconds.load(std::memory_order_relaxed))});
+        }
+        return res;
+    }
+
+    void reset() noexcept {
+        std::scoped_lock lock(m_mutex);
+        for (auto &[name, c] : m_counters)
+            c->reset();
+    }
+
+    // {"generators": [{"name": ..., "allocations": ..., ...}, ...]}
+    void write_json(std::ostream &out) const {
+        out << "{\"generators\": [";
+        bool first = true;
+        for (const auto &s : snapshot()) {
+            out << (first ? "" : ", ") << "{\"name\": \"";
+            for (char c : s.name) {
+                if (c == '"' || c == '\\')
+                    out << '\\';
+                out << c;
+            }
+            out << "\", \"allocations\": " << s.allocations << ", \"deallocations\": " << s.deallocations
+                << ", \"frame_bytes\": " << s.frame_bytes << ", \"resumes\": " << s.resumes
+                << ", \"yields\": " << s.yields << ", \"time_ns\": " << s.time.count() << "}";
+            first = false;
+        }
+        out << "]}";
+    }
+
+    std::string to_json() const {
+        std::ostringstream out;
+        write_json(out);
+        return out.str();
+    }
+
+  private:
+    instrumentation_registry() = default;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<generator_counters>, std::less<>> m_counters;
+};
+
+namespace detail {
+
+template <typename T>
+constexpr std::string_view type_name() {
+    std::string_view name = __PRETTY_FUNCTION__;
+    const auto begin = name.find("T = ") + 4;
+    return name.substr(begin, name.find_first_of(";]", begin) - begin);
+}
+
+} // namespace detail
+
+// An instrumentation policy for generator, counting the frame allocations,
+// resumptions and yields of each generator type, and the time spent in
+// their coroutines, in the instrumentation_registry.
+//
+//    generator<int, int, void, generator_instrumentation>
+struct generator_instrumentation {
+    template <typename G>
+    static generator_counters &counters() {
+        static generator_counters &c = instrumentation_registry::instance().counters(detail::type_name<G>());
+        return c;
+    }
+
+    template <typename G>
+    static void on_allocate(std::size_t size) noexcept {
+        (void)registered<G>;
+        auto &c = counters<G>();
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.frame_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    template <typename G>
+    static void on_deallocate(std::size_t) noexcept {
+        (void)registered<G>;
+        counters<G>().deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename G>
+    static void on_yield() noexcept {
+        (void)registered<G>;
+        counters<G>().yields.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename G>
+    static void resume(std::coroutine_handle<> coroutine) {
+        struct timer {
+            generator_counters &c;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            ~timer() {
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                c.nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                        std::memory_order_relaxed);
+            }
+        };
+        auto &c = counters<G>();
+        c.resumes.fetch_add(1, std::memory_order_relaxed);
+        timer t{c};
+        coroutine.resume();
+    }
+
+  private:
+    // Referenced by the noexcept notifications, so that the counters of G
+    // are created during dynamic initialization rather than by them
+    template <typename G>
+    static inline const bool registered = (counters<G>(), true);
+};
+
+template <typename YieldedType, typename ValueType = std::remove_cvref_t<YieldedType>, typename Allocator = void>
+using instrumented_generator = generator<YieldedType, ValueType, Allocator, generator_instrumentation>;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,326 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <cor3ntin/rangesnext/__detail.hpp>
+#include <compare>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+// The operations performed on the iterators of an instrumented_view.
+// The counters are not atomic: an instrumented_view should only be
+// iterated on one thread at a time.
+struct iterator_counters {
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+    std::uint64_t increments = 0;
+    std::uint64_t decrements = 0;
+    // +=, -=, + and -
+    std::uint64_t advances = 0;
+    // *, []
+    std::uint64_t dereferences = 0;
+    // ==, <=> against iterators and sentinels
+    std::uint64_t comparisons = 0;
+    // iterator - iterator, iterator - sentinel
+    std::uint64_t distances = 0;
+
+    constexpr void reset() noexcept {
+        *this = {};
+    }
+
+    constexpr std::uint64_t total() const noexcept {
+        return begin + end + increments + decrements + advances + dereferences + comparisons + distances;
+    }
+
+    constexpr bool operator==(const iterator_counters &) const = default;
+
+    friend std::ostream &operator<<(std::ostream &out, const iterator_counters &c) {
+        return out << "{begin: " << c.begin << ", end: " << c.end << ", ++: " << c.increments
+                   << ", --: " << c.decrements << ", +=: " << c.advances << ", *: " << c.dereferences
+                   << ", ==: " << c.comparisons << ", -: " << c.distances << "}";
+    }
+};
+
+// Forwards V, counting the operations on its iterators in an iterator_counters.
+// The iterator category, common-ness and size of V are preserved.
+template <r::input_range V>
+requires r::view<V>
+class instrumented_view : public r::view_interface<instrumented_view<V>> {
+    V m_base = V();
+    iterator_counters *m_counters = nullptr;
+
+    template <bool Const>
+    class sentinel;
+
+    template <bool Const>
+    class iterator {
+        using Base = std::conditional_t<Const, const V, V>;
+
+        r::iterator_t<Base> m_current = r::iterator_t<Base>();
+        iterator_counters *m_counters = nullptr;
+
+        template <bool>
+        friend class iterator;
+        template <bool>
+        friend class sentinel;
+
+      public:
+        using iterator_concept = decltype(detail::iter_cat<Base>());
+        using value_type = r::range_value_t<Base>;
+        using difference_type = r::range_difference_t<Base>;
+
+        iterator() = default;
+
+        constexpr iterator(r::iterator_t<Base> current, iterator_counters *counters)
+            : m_current(std::move(current)), m_counters(counters) {
+        }
+
+        constexpr iterator(iterator<!Const> i) requires Const
+            && std::convertible_to<r::iterator_t<V>, r::iterator_t<Base>>
+            : m_current(std::move(i.m_current)), m_counters(i.m_counters) {
+        }
+
+        constexpr const r::iterator_t<Base> &base() const &noexcept {
+            return m_current;
+        }
+
+        constexpr r::iterator_t<Base> base() && {
+            return std::move(m_current);
+        }
+
+        constexpr decltype(auto) operator*() const {
+            ++m_counters->dereferences;
+            return *m_current;
+        }
+
+        constexpr decltype(auto) operator[](difference_type n) const requires r::random_access_range<Base> {
+            ++m_counters->dereferences;
+            return m_current[n];
+        }
+
+        constexpr iterator &operator++() {
+            ++m_counters->increments;
+            ++m_current;
+            return *this;
+        }
+
+        constexpr void operator++(int) {
+            ++*this;
+        }
+
+        constexpr iterator operator++(int) requires r::forward_range<Base> {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator--() requires r::bidirectional_range<Base> {
+            ++m_counters->decrements;
+            --m_current;
+            return *this;
+        }
+
+        constexpr iterator operator--(int) requires r::bidirectional_range<Base> {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator+=(difference_type n) requires r::random_access_range<Base> {
+            ++m_counters->advances;
+            m_current += n;
+            return *this;
+        }
+
+        constexpr iterator &operator-=(difference_type n) requires r::random_access_range<Base> {
+            ++m_counters->advances;
+            m_current -= n;
+            return *this;
+        }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) requires r::random_access_range<Base> {
+            return i += n;
+        }
+
+        friend constexpr iterator operator+(difference_type n, iterator i) requires r::random_access_range<Base> {
+            return i += n;
+        }
+
+        friend constexpr iterator operator-(iterator i, difference_type n) requires r::random_access_range<Base> {
+            return i -= n;
+        }
+
+        friend constexpr difference_type operator-(const iterator &x, const iterator &y) requires
+            std::sized_sentinel_for<r::iterator_t<Base>, r::iterator_t<Base>> {
+            ++x.m_counters->distances;
+            return x.m_current - y.m_current;
+        }
+
+        friend constexpr bool operator==(const iterator &x, const iterator &y) requires
+            std::equality_comparable<r::iterator_t<Base>> {
+            ++x.m_counters->comparisons;
+            return x.m_current == y.m_current;
+        }
+
+        friend constexpr auto operator<=>(const iterator &x, const iterator &y) requires
+            r::random_access_range<Base> && std::three_way_comparable<r::iterator_t<Base>> {
+            ++x.m_counters->comparisons;
+            return x.m_current <=> y.m_current;
+        }
+
+        friend constexpr decltype(auto) iter_move(const iterator &i) noexcept(
+            noexcept(r::iter_move(i.m_current))) {
+            return r::iter_move(i.m_current);
+        }
+    };
+
+    template <bool Const>
+    class sentinel {
+        using Base = std::conditional_t<Const, const V, V>;
+
+        r::sentinel_t<Base> m_end = r::sentinel_t<Base>();
+
+        template <bool>
+        friend class sentinel;
+
+      public:
+        sentinel() = default;
+
+        constexpr explicit sentinel(r::sentinel_t<Base> end) : m_end(std::move(end)) {
+        }
+
+        constexpr sentinel(sentinel<!Const> s) requires Const
+            && std::convertible_to<r::sentinel_t<V>, r::sentinel_t<Base>> : m_end(std::move(s.m_end)) {
+        }
+
+        constexpr r::sentinel_t<Base> base() const {
+            return m_end;
+        }
+
+        friend constexpr bool operator==(const iterator<Const> &x, const sentinel &y) {
+            return y.equal(x);
+        }
+
+        friend constexpr r::range_difference_t<Base> operator-(const iterator<Const> &x, const sentinel &y) requires
+            std::sized_sentinel_for<r::sentinel_t<Base>, r::iterator_t<Base>> {
+            return -y.distance_to(x);
+        }
+
+        friend constexpr r::range_difference_t<Base> operator-(const sentinel &x, const iterator<Const> &y) requires
+            std::sized_sentinel_for<r::sentinel_t<Base>, r::iterator_t<Base>> {
+            return x.distance_to(y);
+        }
+
+      private:
+        constexpr bool equal(const iterator<Const> &i) const {
+            ++i.m_counters->comparisons;
+            return i.m_current == m_end;
+        }
+
+        constexpr r::range_difference_t<Base> distance_to(const iterator<Const> &i) const {
+            ++i.m_counters->distances;
+            return m_end - i.m_current;
+        }
+    };
+
+    template <bool Const, typename Self>
+    static constexpr auto make_end(Self &self) {
+        using Base = std::conditional_t<Const, const V, V>;
+        ++self.m_counters->end;
+        if constexpr (r::common_range<Base>)
+            return iterator<Const>(r::end(self.m_base), self.m_counters);
+        else
+            return sentinel<Const>(r::end(self.m_base));
+    }
+
+  public:
+    instrumented_view() = default;
+
+    constexpr instrumented_view(V base, iterator_counters &counters)
+        : m_base(std::move(base)), m_counters(std::addressof(counters)) {
+    }
+
+    constexpr auto begin() requires(!detail::simple_view<V>) {
+        ++m_counters->begin;
+        return iterator<false>(r::begin(m_base), m_counters);
+    }
+
+    constexpr auto begin() const requires r::input_range<const V> {
+        ++m_counters->begin;
+        return iterator<true>(r::begin(m_base), m_counters);
+    }
+
+    constexpr auto end() requires(!detail::simple_view<V>) {
+        return make_end<false>(*this);
+    }
+
+    constexpr auto end() const requires r::input_range<const V> {
+        return make_end<true>(*this);
+    }
+
+    constexpr auto size() requires r::sized_range<V> {
+        return r::size(m_base);
+    }
+
+    constexpr auto size() const requires r::sized_range<const V> {
+        return r::size(m_base);
+    }
+
+    constexpr V base() const &requires std::copy_constructible<V> {
+        return m_base;
+    }
+
+    constexpr V base() && {
+        return std::move(m_base);
+    }
+
+    constexpr iterator_counters &counters() const noexcept {
+        return *m_counters;
+    }
+};
+
+template <typename R>
+instrumented_view(R &&, iterator_counters &) -> instrumented_view<r::views::all_t<R>>;
+
+namespace detail {
+
+struct instrumented_closure {
+    iterator_counters *counters;
+
+    template <r::viewable_range R>
+    requires r::input_range<R>
+    friend constexpr auto operator|(R &&rng, instrumented_closure c) {
+        return instrumented_view{std::forward<R>(rng), *c.counters};
+    }
+};
+
+struct instrumented_fn {
+    template <r::viewable_range R>
+    requires r::input_range<R>
+    constexpr auto operator()(R &&rng, iterator_counters &counters) const {
+        return instrumented_view{std::forward<R>(rng), counters};
+    }
+
+    constexpr instrumented_closure operator()(iterator_counters &counters) const {
+        return {std::addressof(counters)};
+    }
+};
+
+} // namespace detail
+
+inline constexpr detail::instrumented_fn instrumented;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,248 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+// A read-only memory mapping of a whole file (POSIX only)
+class mapped_file {
+  public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::filesystem::path &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::system_category(), "open " + path.string());
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::system_category(), "fstat " + path.string());
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size != 0) {
+            void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::system_category(), "mmap " + path.string());
+            }
+            m_data = static_cast<const char *>(data);
+            ::madvise(data, m_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+
+    mapped_file(mapped_file &&other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {
+    }
+
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (m_data)
+            ::munmap(const_cast<char *>(m_data), m_size);
+    }
+
+    const char *data() const noexcept {
+        return m_data;
+    }
+
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    std::string_view view() const noexcept {
+        return {m_data, m_size};
+    }
+
+    // Hints the kernel about the access pattern, MADV_SEQUENTIAL by default
+    void advise(int advice) const noexcept {
+        if (m_data)
+            ::madvise(const_cast<char *>(m_data), m_size, advice);
+    }
+
+  private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+// A record of a mapped file: a string_view into the mapping,
+// which it keeps alive, so that records can outlive their view.
+// Plain string_views copied from a record don't.
+class mapped_record : public std::string_view {
+  public:
+    mapped_record() = default;
+
+    mapped_record(std::string_view record, std::shared_ptr<const mapped_file> file) noexcept
+        : std::string_view(record), m_file(std::move(file)) {
+    }
+
+  private:
+    std::shared_ptr<const mapped_file> m_file;
+};
+
+// The records of a mapped file, separated by a delimiter, as mapped_records.
+// The mapping is kept alive by the view, its copies and the records.
+// Like std::getline, a delimiter at the end of the file does not start
+// an empty record.
+class mapped_records_view : public r::view_interface<mapped_records_view> {
+    struct state {
+        mapped_file file;
+        char delimiter;
+        std::once_flag indexed;
+        // offsets of the first character of each record, followed by
+        // the offset one past the delimiter ending the last one
+        std::vector<std::size_t> starts;
+
+        void build_index() {
+            const std::string_view content = file.view();
+            std::size_t pos = 0;
+            while (pos < content.size()) {
+                starts.push_back(pos);
+                const auto next = content.find(delimiter, pos);
+                pos = next == std::string_view::npos ? content.size() + 1 : next + 1;
+            }
+            starts.push_back(pos);
+        }
+    };
+
+  public:
+    class iterator {
+      public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = mapped_record;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        mapped_record operator*() const noexcept {
+            return {std::string_view(m_begin, static_cast<std::size_t>(m_end - m_begin)), m_file};
+        }
+
+        iterator &operator++() noexcept {
+            m_begin = m_end == m_last ? m_last : m_end + 1;
+            find_end();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator &a, const iterator &b) noexcept {
+            return a.m_begin == b.m_begin;
+        }
+
+        friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept {
+            return it.m_begin == it.m_last;
+        }
+
+      private:
+        friend mapped_records_view;
+
+        iterator(std::shared_ptr<const mapped_file> file, char delimiter) noexcept
+            : m_begin(file->data()), m_last(file->data() + file->size()), m_delimiter(delimiter),
+              m_file(std::move(file)) {
+            find_end();
+        }
+
+        void find_end() noexcept {
+            const void *p = m_begin == m_last ? nullptr : std::memchr(m_begin, m_delimiter, m_last - m_begin);
+            m_end = p ? static_cast<const char *>(p) : m_last;
+        }
+
+        const char *m_begin = nullptr;
+        const char *m_end = nullptr;
+        const char *m_last = nullptr;
+        char m_delimiter = '\n';
+        std::shared_ptr<const mapped_file> m_file;
+    };
+
+    mapped_records_view() = default;
+
+    mapped_records_view(mapped_file file, char delimiter)
+        : m_state(std::make_shared<state>(std::move(file), delimiter)) {
+    }
+
+    // A default constructed view is empty
+    iterator begin() const noexcept {
+        if (!m_state)
+            return {};
+        return iterator{file_ptr(m_state), m_state->delimiter};
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return std::default_sentinel;
+    }
+
+    // A random access view of the records.
+    // The offsets of the records are computed on the first call,
+    // and shared by the copies of this view.
+    auto indexed() const {
+        std::size_t size = 0;
+        if (m_state) {
+            std::call_once(m_state->indexed, [s = m_state.get()] { s->build_index(); });
+            size = m_state->starts.size() - 1;
+        }
+        auto record = [s = m_state](std::size_t i) {
+            const auto begin = s->starts[i];
+            return mapped_record{s->file.view().substr(begin, s->starts[i + 1] - 1 - begin), file_ptr(s)};
+        };
+        return r::views::iota(std::size_t(0), size) | r::views::transform(std::move(record));
+    }
+
+    const mapped_file &file() const noexcept {
+        static const mapped_file empty;
+        return m_state ? m_state->file : empty;
+    }
+
+  private:
+    // Shares the ownership of the state
+    static std::shared_ptr<const mapped_file> file_ptr(const std::shared_ptr<state> &s) noexcept {
+        return {s, &s->file};
+    }
+
+    std::shared_ptr<state> m_state;
+};
+
+inline mapped_records_view mapped_records(const std::filesystem::path &path, char delimiter) {
+    return mapped_records_view{mapped_file{path}, delimiter};
+}
+
+inline mapped_records_view mapped_lines(const std::filesystem::path &path) {
+    return mapped_records(path, '\n');
+}
+
+} // namespace cor3ntin::rangesnext
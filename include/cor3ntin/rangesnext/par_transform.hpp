@@ -0,0 +1,247 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cor3ntin/rangesnext/thread_pool.hpp>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+// Applies F to the elements of V on a thread pool, producing the results
+// in the order of V.
+// V is iterated on the consumer thread, at most window elements ahead
+// of the consumer; the elements are copied (or moved) to the tasks.
+// Exceptions thrown by F are rethrown when the consumer reaches the
+// corresponding element. Exceptions thrown while iterating V are
+// rethrown once the results of the elements read before are consumed.
+template <r::input_range V, std::copy_constructible F>
+requires r::view<V> && std::invocable<F &, r::range_value_t<V> &&>
+class par_transform_view : public r::view_interface<par_transform_view<V, F>> {
+    using source_type = r::range_value_t<V>;
+    using result_type = std::remove_cvref_t<std::invoke_result_t<F &, source_type &&>>;
+
+    struct slot {
+        std::optional<source_type> source;
+        std::optional<result_type> result;
+        std::exception_ptr exception;
+        std::atomic<bool> ready = false;
+    };
+
+    struct state {
+        V base;
+        F fn;
+        std::size_t window;
+        std::unique_ptr<thread_pool> own_pool;
+        thread_pool *pool;
+        std::optional<r::iterator_t<V>> source;
+        // shared with the tasks, which may still be notifying a slot once it is ready
+        std::deque<std::shared_ptr<slot>> in_flight;
+        // thrown while iterating base, nothing more is read from it
+        std::exception_ptr source_exception;
+        bool source_failed = false;
+
+        state(V base, F fn, unsigned threads, std::size_t window)
+            : base(std::move(base)), fn(std::move(fn)),
+              own_pool(threads ? std::make_unique<thread_pool>(threads) : nullptr),
+              pool(own_pool ? own_pool.get() : &thread_pool::default_pool()) {
+            this->window = window ? window : std::size_t(pool->size()) * 2;
+        }
+
+        // The tasks reference fn
+        ~state() {
+            for (auto &s : in_flight)
+                wait(*s);
+        }
+
+        void start() {
+            source = r::begin(base);
+            fill();
+        }
+
+        // A slot is only added to in_flight once its task is submitted:
+        // the destructor waits for every slot, and the source may throw.
+        void fill() {
+            if (source_failed)
+                return;
+            try {
+                while (in_flight.size() < window && *source != r::end(base)) {
+                    auto s = std::make_shared<slot>();
+                    s->source.emplace(**source);
+                    in_flight.push_back(s);
+                    try {
+                        submit(s);
+                    } catch (...) {
+                        in_flight.pop_back();
+                        throw;
+                    }
+                    // advanced once the element is submitted, which is delivered if this throws
+                    ++*source;
+                }
+            } catch (...) {
+                source_exception = std::current_exception();
+                source_failed = true;
+            }
+        }
+
+        void submit(std::shared_ptr<slot> s) {
+            pool->submit([this, s = std::move(s)] {
+                try {
+                    s->result.emplace(std::invoke(fn, std::move(*s->source)));
+                } catch (...) {
+                    s->exception = std::current_exception();
+                }
+                s->source.reset();
+                s->ready.store(true, std::memory_order_release);
+                s->ready.notify_one();
+            });
+        }
+
+        void wait(slot &s) {
+            while (!s.ready.load(std::memory_order_acquire)) {
+                if (!pool->try_run_one())
+                    s.ready.wait(false, std::memory_order_acquire);
+            }
+        }
+
+        // The result of the oldest element, nullptr at the end
+        result_type *front() {
+            if (in_flight.empty()) {
+                if (source_exception)
+                    std::rethrow_exception(std::exchange(source_exception, nullptr));
+                return nullptr;
+            }
+            auto &s = *in_flight.front();
+            wait(s);
+            if (s.exception)
+                std::rethrow_exception(std::exchange(s.exception, nullptr));
+            return std::addressof(*s.result);
+        }
+
+        void pop() {
+            in_flight.pop_front();
+            fill();
+        }
+    };
+
+    struct sentinel {};
+
+    class iterator {
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = result_type;
+
+        iterator() = default;
+        iterator(iterator &&) = default;
+        iterator &operator=(iterator &&) = default;
+
+        value_type &operator*() const noexcept {
+            return *m_current;
+        }
+
+        iterator &operator++() {
+            m_current = nullptr;
+            m_state->pop();
+            m_current = m_state->front();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(sentinel) const noexcept {
+            return m_current == nullptr;
+        }
+
+      private:
+        friend par_transform_view;
+
+        explicit iterator(state *s) : m_state(s), m_current(s->front()) {
+        }
+
+        state *m_state = nullptr;
+        value_type *m_current = nullptr;
+    };
+
+  public:
+    par_transform_view() = default;
+
+    // threads = 0 uses the default thread pool,
+    // window = 0 allows twice as many elements as threads in flight
+    par_transform_view(V base, F fn, unsigned threads = 0, std::size_t window = 0)
+        : m_state(std::make_unique<state>(std::move(base), std::move(fn), threads, window)) {
+    }
+
+    // A default constructed view is empty
+    iterator begin() {
+        if (!m_state)
+            return {};
+        assert(!m_state->source && "begin() can only be called once on a par_transform_view");
+        if (!m_state->source)
+            m_state->start();
+        return iterator{m_state.get()};
+    }
+
+    sentinel end() const noexcept {
+        return {};
+    }
+
+  private:
+    std::unique_ptr<state> m_state;
+};
+
+template <typename R, typename F>
+par_transform_view(R &&, F, unsigned = 0, std::size_t = 0) -> par_transform_view<r::views::all_t<R>, F>;
+
+namespace detail {
+
+template <typename F>
+struct par_transform_closure {
+    F fn;
+    unsigned threads;
+    std::size_t window;
+
+    template <r::viewable_range R>
+    requires r::input_range<R>
+    friend auto operator|(R &&rng, par_transform_closure c) {
+        return par_transform_view{std::forward<R>(rng), std::move(c.fn), c.threads, c.window};
+    }
+};
+
+struct par_transform_fn {
+    template <r::viewable_range R, typename F>
+    requires r::input_range<R>
+    auto operator()(R &&rng, F fn, unsigned threads = 0, std::size_t window = 0) const {
+        return par_transform_view{std::forward<R>(rng), std::move(fn), threads, window};
+    }
+
+    template <typename F>
+    requires(!r::range<F>)
+    par_transform_closure<F> operator()(F fn, unsigned threads = 0, std::size_t window = 0) const {
+        return {std::move(fn), threads, window};
+    }
+};
+
+} // namespace detail
+
+inline detail::par_transform_fn par_transform;
+
+} // namespace cor3ntin::rangesnext
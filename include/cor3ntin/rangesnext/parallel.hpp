@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cor3ntin/rangesnext/thread_pool.hpp>
+#include <cor3ntin/rangesnext/top_k.hpp>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cor3ntin::rangesnext::par {
+
+namespace r = std::ranges;
+
+// Ranges which can be split in chunks in constant time,
+// such as product_view and enumerate_view of random access ranges
+template <typename R>
+concept splittable_range = r::random_access_range<R> && r::sized_range<R>;
+
+namespace detail {
+
+// Splits [0, size) in chunks of at most grain elements, processed on pool.
+// Each task splits its range in halves, submitting the upper half, until it
+// is small enough to be processed: idle threads steal the largest pending
+// chunks first.
+// Returns once all chunks are processed, rethrowing the first exception.
+template <typename F>
+void parallel_chunks(thread_pool &pool, std::size_t size, std::size_t grain, F &&process) {
+    if (size == 0)
+        return;
+    if (grain == 0)
+        grain = std::max<std::size_t>(1, size / (std::size_t(pool.size()) * 8));
+    if (size <= grain || pool.size() == 1) {
+        process(std::size_t(0), size);
+        return;
+    }
+
+    struct state {
+        thread_pool &pool;
+        std::size_t grain;
+        F &process;
+        std::atomic<std::size_t> pending = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr exception;
+
+        state(thread_pool &pool, std::size_t grain, F &process) : pool(pool), grain(grain), process(process) {
+        }
+
+        void run(std::size_t begin, std::size_t end) {
+            try {
+                while (end - begin > grain && !failed.load(std::memory_order_relaxed)) {
+                    const std::size_t middle = begin + (end - begin) / 2;
+                    pending.fetch_add(1, std::memory_order_relaxed);
+                    pool.submit([this, middle, end] { run(middle, end); });
+                    end = middle;
+                }
+                if (!failed.load(std::memory_order_relaxed))
+                    process(begin, end);
+            } catch (...) {
+                if (!failed.exchange(true))
+                    exception = std::current_exception();
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    state s(pool, grain, process);
+    s.pending = 1;
+    s.run(0, size);
+    while (s.pending.load(std::memory_order_acquire) != 0) {
+        if (!pool.try_run_one())
+            std::this_thread::yield();
+    }
+    if (s.exception)
+        std::rethrow_exception(s.exception);
+}
+
+} // namespace detail
+
+// Invokes f on each element of rng, in parallel when rng is splittable,
+// sequentially otherwise.
+// grain is the maximum number of elements processed by a task,
+// 0 selects it from the size of the range and the number of threads.
+template <r::input_range R, typename F>
+void for_each(R &&rng, F f, std::size_t grain = 0, thread_pool &pool = thread_pool::default_pool()) {
+    if constexpr (splittable_range<R>) {
+        detail::parallel_chunks(pool, static_cast<std::size_t>(r::size(rng)), grain,
+                                [&](std::size_t begin, std::size_t end) {
+                                    auto it = r::begin(rng) + static_cast<r::range_difference_t<R>>(begin);
+                                    for (std::size_t i = begin; i < end; ++i, ++it)
+                                        std::invoke(f, *it);
+                                });
+    } else {
+        for (auto &&e : rng)
+            std::invoke(f, std::forward<decltype(e)>(e));
+    }
+}
+
+// Reduces the transformed elements of rng, starting with init.
+// reduce must be associative, it is not required to be commutative.
+template <r::input_range R, typename T, typename Reduce, typename Transform>
+T transform_reduce(R &&rng, T init, Reduce reduce, Transform transform, std::size_t grain = 0,
+                   thread_pool &pool = thread_pool::default_pool()) {
+    if constexpr (splittable_range<R>) {
+        std::mutex mutex;
+        std::vector<std::pair<std::size_t, T>> partials;
+        detail::parallel_chunks(pool, static_cast<std::size_t>(r::size(rng)), grain,
+                                [&](std::size_t begin, std::size_t end) {
+                                    auto it = r::begin(rng) + static_cast<r::range_difference_t<R>>(begin);
+                                    T acc = std::invoke(transform, *it);
+                                    for (std::size_t i = begin + 1; i < end; ++i)
+                                        acc = std::invoke(reduce, std::move(acc), std::invoke(transform, *++it));
+                                    std::scoped_lock lock(mutex);
+                                    partials.emplace_back(begin, std::move(acc));
+                                });
+        std::ranges::sort(partials, {}, &std::pair<std::size_t, T>::first);
+        for (auto &p : partials)
+            init = std::invoke(reduce, std::move(init), std::move(p.second));
+    } else {
+        for (auto &&e : rng)
+            init = std::invoke(reduce, std::move(init), std::invoke(transform, std::forward<decltype(e)>(e)));
+    }
+    return init;
+}
+
+template <r::input_range R, typename Pred>
+std::size_t count_if(R &&rng, Pred pred, std::size_t grain = 0, thread_pool &pool = thread_pool::default_pool()) {
+    return par::transform_reduce(
+        std::forward<R>(rng), std::size_t(0), std::plus<>{},
+        [&](auto &&e) -> std::size_t { return std::invoke(pred, std::forward<decltype(e)>(e)) ? 1 : 0; }, grain,
+        pool);
+}
+
+namespace detail {
+
+// The k smallest elements of rng. Each chunk fills its own bounded heap,
+// which is then merged into the result: at most k elements are held per task.
+template <typename R, typename Comp, typename Proj>
+auto bounded_heap_of(R &rng, std::size_t k, Comp comp, Proj proj, std::size_t grain, thread_pool &pool) {
+    auto heap = rangesnext::detail::make_bounded_heap(rng, k, comp, proj);
+    if constexpr (splittable_range<R>) {
+        std::mutex mutex;
+        parallel_chunks(pool, static_cast<std::size_t>(r::size(rng)), grain, [&](std::size_t begin, std::size_t end) {
+            rangesnext::detail::bounded_heap_for<R, Comp, Proj> local(k, comp, proj);
+            local.reserve(end - begin);
+            const auto first = r::begin(rng) + static_cast<r::range_difference_t<R>>(begin);
+            local.push_range(r::subrange(first, first + static_cast<r::range_difference_t<R>>(end - begin)));
+            std::scoped_lock lock(mutex);
+            heap.merge(std::move(local));
+        });
+    } else {
+        heap.push_range(rng);
+    }
+    return heap;
+}
+
+} // namespace detail
+
+// rangesnext::top_k, in parallel when rng is splittable
+template <r::input_range R, typename Comp = r::less, typename Proj = std::identity>
+requires rangesnext::detail::top_k_range<R, Comp, Proj>
+auto top_k(R &&rng, std::size_t k, Comp comp = {}, Proj proj = {}, std::size_t grain = 0,
+           thread_pool &pool = thread_pool::default_pool()) -> std::vector<r::range_value_t<R>> {
+    return detail::bounded_heap_of(rng, k, std::move(comp), std::move(proj), grain, pool).sorted();
+}
+
+// rangesnext::nth_smallest, in parallel when rng is splittable
+template <r::input_range R, typename Comp = r::less, typename Proj = std::identity>
+requires rangesnext::detail::top_k_range<R, Comp, Proj>
+auto nth_smallest(R &&rng, std::size_t n, Comp comp = {}, Proj proj = {}, std::size_t grain = 0,
+                  thread_pool &pool = thread_pool::default_pool()) -> std::optional<r::range_value_t<R>> {
+    return detail::bounded_heap_of(rng, n + 1, std::move(comp), std::move(proj), grain, pool).kth();
+}
+
+} // namespace cor3ntin::rangesnext::par
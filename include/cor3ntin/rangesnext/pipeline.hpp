@@ -0,0 +1,223 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+template <typename F>
+struct transform_stage {
+    [[no_unique_address]] F fn;
+};
+
+template <typename P>
+struct filter_stage {
+    [[no_unique_address]] P pred;
+};
+
+// The type produced by a sequence of stages, for elements of type T
+template <typename T, typename... Stages>
+struct pipeline_result {
+    using type = T;
+};
+
+template <typename T, typename F, typename... Stages>
+struct pipeline_result<T, transform_stage<F>, Stages...>
+    : pipeline_result<std::invoke_result_t<F &, T>, Stages...> {};
+
+template <typename T, typename P, typename... Stages>
+struct pipeline_result<T, filter_stage<P>, Stages...> : pipeline_result<T, Stages...> {};
+
+// Whether the element produced by a sequence of stages outlives the stages.
+// The elements of the base live until the next one is produced; a prvalue
+// produced by a stage is destroyed once the stages return, and so is
+// anything which a later stage returns a reference to.
+template <bool Alive, typename T, typename... Stages>
+struct pipeline_result_alive : std::bool_constant<Alive> {};
+
+template <bool Alive, typename T, typename F, typename... Stages>
+struct pipeline_result_alive<Alive, T, transform_stage<F>, Stages...>
+    : pipeline_result_alive<Alive && std::is_lvalue_reference_v<std::invoke_result_t<F &, T>>,
+                            std::invoke_result_t<F &, T>, Stages...> {};
+
+template <bool Alive, typename T, typename P, typename... Stages>
+struct pipeline_result_alive<Alive, T, filter_stage<P>, Stages...> : pipeline_result_alive<Alive, T, Stages...> {};
+
+// Holds the output of the stages for the current element
+template <typename T>
+struct pipeline_slot {
+    std::optional<T> value;
+
+    template <typename U>
+    void set(U &&u) {
+        value.emplace(std::forward<U>(u));
+    }
+    explicit operator bool() const noexcept {
+        return value.has_value();
+    }
+    T &&get() noexcept {
+        return std::move(*value);
+    }
+};
+
+template <typename T>
+struct pipeline_slot<T &> {
+    T *value = nullptr;
+
+    void set(T &u) noexcept {
+        value = std::addressof(u);
+    }
+    explicit operator bool() const noexcept {
+        return value != nullptr;
+    }
+    T &get() const noexcept {
+        return *value;
+    }
+};
+
+template <typename... Stages>
+struct pipeline_closure;
+
+} // namespace detail
+
+// Applies a sequence of co_transform and co_filter stages to V,
+// all in the frame of a single generator coroutine: each element
+// costs one resumption, whatever the number of stages.
+// The generator is created by begin(), from copies of the base and the
+// stages if the base is copyable, otherwise begin() can only be called once.
+template <r::input_range V, typename... Stages>
+requires r::view<V>
+class fused_pipeline : public r::view_interface<fused_pipeline<V, Stages...>> {
+    using result = typename detail::pipeline_result<r::range_reference_t<V>, Stages...>::type;
+    static constexpr bool by_reference =
+        std::is_lvalue_reference_v<result> &&
+        detail::pipeline_result_alive<true, r::range_reference_t<V>, Stages...>::value;
+
+  public:
+    // lvalues are yielded by reference, unless they may refer to a temporary
+    // produced by a stage; other results are yielded as rvalues
+    using generator_type =
+        std::conditional_t<by_reference, generator<result>, generator<std::remove_cvref_t<result> &&>>;
+
+    fused_pipeline() = default;
+
+    fused_pipeline(V base, std::tuple<Stages...> stages) : m_base(std::move(base)), m_stages(std::move(stages)) {
+    }
+
+    auto begin() {
+        if constexpr (std::copyable<V>) {
+            m_generator = run(m_base, m_stages);
+        } else {
+            assert(!m_started && "begin() can only be called once on a pipeline over a move-only view");
+            m_started = true;
+            m_generator = run(std::move(m_base), std::move(m_stages));
+        }
+        return m_generator.begin();
+    }
+
+    auto end() const noexcept {
+        return m_generator.end();
+    }
+
+    // Appends more stages, to the same coroutine
+    template <typename... More>
+    friend fused_pipeline<V, Stages..., More...> operator|(fused_pipeline &&pipeline,
+                                                           detail::pipeline_closure<More...> closure) {
+        return {std::move(pipeline.m_base), std::tuple_cat(std::move(pipeline.m_stages), std::move(closure.stages))};
+    }
+
+  private:
+    static generator_type run(V base, std::tuple<Stages...> stages) {
+        for (auto &&element : base) {
+            detail::pipeline_slot<std::conditional_t<by_reference, result, std::remove_cvref_t<result>>> slot;
+            apply<0>(stages, std::forward<decltype(element)>(element), slot);
+            if (slot)
+                co_yield slot.get();
+        }
+    }
+
+    template <std::size_t I, typename T, typename Slot>
+    static void apply(std::tuple<Stages...> &stages, T &&element, Slot &slot) {
+        if constexpr (I == sizeof...(Stages)) {
+            slot.set(std::forward<T>(element));
+        } else {
+            auto &stage = std::get<I>(stages);
+            if constexpr (requires { stage.fn; }) {
+                apply<I + 1>(stages, std::invoke(stage.fn, std::forward<T>(element)), slot);
+            } else if (std::invoke(stage.pred, element)) {
+                apply<I + 1>(stages, std::forward<T>(element), slot);
+            }
+        }
+    }
+
+    V m_base;
+    std::tuple<Stages...> m_stages;
+    generator_type m_generator;
+    bool m_started = false;
+};
+
+namespace detail {
+
+template <typename R>
+inline constexpr bool is_fused_pipeline = false;
+
+template <typename V, typename... Stages>
+inline constexpr bool is_fused_pipeline<fused_pipeline<V, Stages...>> = true;
+
+template <typename... Stages>
+struct pipeline_closure {
+    std::tuple<Stages...> stages;
+
+    // rvalue pipelines are extended instead
+    template <r::viewable_range R>
+    requires r::input_range<R> && (!is_fused_pipeline<R>)
+    friend auto operator|(R &&rng, pipeline_closure closure) {
+        return fused_pipeline<r::views::all_t<R>, Stages...>{r::views::all(std::forward<R>(rng)),
+                                                             std::move(closure.stages)};
+    }
+
+    template <typename... More>
+    friend pipeline_closure<Stages..., More...> operator|(pipeline_closure a, pipeline_closure<More...> b) {
+        return {std::tuple_cat(std::move(a.stages), std::move(b.stages))};
+    }
+};
+
+struct co_transform_fn {
+    template <std::copy_constructible F>
+    pipeline_closure<transform_stage<std::decay_t<F>>> operator()(F &&f) const {
+        return {{{std::forward<F>(f)}}};
+    }
+};
+
+struct co_filter_fn {
+    template <std::copy_constructible P>
+    pipeline_closure<filter_stage<std::decay_t<P>>> operator()(P &&p) const {
+        return {{{std::forward<P>(p)}}};
+    }
+};
+
+} // namespace detail
+
+inline detail::co_transform_fn co_transform;
+inline detail::co_filter_fn co_filter;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,253 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+// A bounded single producer, single consumer queue.
+// head is only written by the consumer and tail by the producer.
+// The high bit of tail marks the end of the sequence.
+template <typename T>
+class spsc_ring {
+  public:
+    static constexpr std::size_t closed_bit = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+
+    explicit spsc_ring(std::size_t capacity)
+        : m_slots(std::make_unique<std::optional<T>[]>(capacity)), m_capacity(capacity) {
+    }
+
+    // Blocks while the queue is full.
+    // Returns false, without pushing, if the consumer went away.
+    template <typename U>
+    bool push(U &&value, const std::stop_token &token) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        while (tail - head == m_capacity) {
+            if (token.stop_requested())
+                return false;
+            m_head.wait(head, std::memory_order_acquire);
+            head = m_head.load(std::memory_order_acquire);
+        }
+        if (token.stop_requested())
+            return false;
+        m_slots[tail % m_capacity].emplace(std::forward<U>(value));
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_tail.notify_one();
+        return true;
+    }
+
+    void close(std::exception_ptr exception) noexcept {
+        m_exception = std::move(exception);
+        m_tail.fetch_or(closed_bit, std::memory_order_release);
+        m_tail.notify_one();
+    }
+
+    // Blocks until an element is available, returns nullptr at the end of the sequence
+    T *front() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        std::size_t tail = m_tail.load(std::memory_order_acquire);
+        while ((tail & ~closed_bit) == head) {
+            if (tail & closed_bit) {
+                if (m_exception)
+                    std::rethrow_exception(std::exchange(m_exception, nullptr));
+                return nullptr;
+            }
+            m_tail.wait(tail, std::memory_order_acquire);
+            tail = m_tail.load(std::memory_order_acquire);
+        }
+        return std::addressof(*m_slots[head % m_capacity]);
+    }
+
+    void pop() noexcept {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        m_slots[head % m_capacity].reset();
+        m_head.store(head + 1, std::memory_order_release);
+        m_head.notify_one();
+    }
+
+    // Wakes up a producer blocked in push
+    void cancel() noexcept {
+        m_head.fetch_add(m_capacity, std::memory_order_release);
+        m_head.notify_one();
+    }
+
+  private:
+    std::unique_ptr<std::optional<T>[]> m_slots;
+    std::size_t m_capacity;
+    std::exception_ptr m_exception;
+    alignas(64) std::atomic<std::size_t> m_head = 0;
+    alignas(64) std::atomic<std::size_t> m_tail = 0;
+};
+
+} // namespace detail
+
+// Iterates over V on a worker thread, at most depth elements ahead
+// of the consumer.
+// The elements are copied (or moved, for ranges of rvalues) through a
+// bounded queue, exceptions thrown while iterating V are rethrown
+// by the consumer.
+// The iteration starts on the call to begin(), which can only be called once,
+// V is then only accessed by the worker thread, until the view is destroyed.
+template <r::input_range V>
+requires r::view<V> && std::constructible_from<r::range_value_t<V>, r::range_reference_t<V>>
+class prefetch_view : public r::view_interface<prefetch_view<V>> {
+    using value_type = r::range_value_t<V>;
+
+    struct state {
+        V base;
+        detail::spsc_ring<value_type> queue;
+        std::jthread worker;
+
+        state(V base, std::size_t depth) : base(std::move(base)), queue(depth) {
+        }
+
+        ~state() {
+            if (worker.joinable()) {
+                worker.request_stop();
+                queue.cancel();
+                worker.join();
+            }
+        }
+
+        void run(std::stop_token token) noexcept {
+            try {
+                for (auto &&value : base) {
+                    if (!queue.push(std::forward<decltype(value)>(value), token))
+                        return;
+                }
+                queue.close(nullptr);
+            } catch (...) {
+                queue.close(std::current_exception());
+            }
+        }
+    };
+
+    struct sentinel {};
+
+    class iterator {
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = prefetch_view::value_type;
+
+        iterator() = default;
+        iterator(iterator &&) = default;
+        iterator &operator=(iterator &&) = default;
+
+        value_type &operator*() const noexcept {
+            return *m_current;
+        }
+
+        iterator &operator++() {
+            m_state->queue.pop();
+            m_current = m_state->queue.front();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(sentinel) const noexcept {
+            return m_current == nullptr;
+        }
+
+      private:
+        friend prefetch_view;
+
+        explicit iterator(state *s) : m_state(s), m_current(s->queue.front()) {
+        }
+
+        state *m_state = nullptr;
+        value_type *m_current = nullptr;
+    };
+
+  public:
+    static constexpr std::size_t default_depth = 64;
+
+    prefetch_view() = default;
+
+    explicit prefetch_view(V base, std::size_t depth = default_depth)
+        : m_state(std::make_unique<state>(std::move(base), depth ? depth : 1)) {
+    }
+
+    // A default constructed view is empty
+    iterator begin() {
+        if (!m_state)
+            return {};
+        assert(!m_state->worker.joinable() && "begin() can only be called once on a prefetch_view");
+        if (!m_state->worker.joinable())
+            m_state->worker = std::jthread([s = m_state.get()](std::stop_token token) { s->run(std::move(token)); });
+        return iterator{m_state.get()};
+    }
+
+    sentinel end() const noexcept {
+        return {};
+    }
+
+  private:
+    std::unique_ptr<state> m_state;
+};
+
+template <typename R>
+prefetch_view(R &&) -> prefetch_view<r::views::all_t<R>>;
+
+template <typename R>
+prefetch_view(R &&, std::size_t) -> prefetch_view<r::views::all_t<R>>;
+
+namespace detail {
+
+struct prefetch_fn {
+    template <r::viewable_range R>
+    requires r::input_range<R>
+    auto operator()(R &&rng, std::size_t depth = prefetch_view<r::views::all_t<R>>::default_depth) const {
+        return prefetch_view{std::forward<R>(rng), depth};
+    }
+
+    struct closure {
+        std::size_t depth;
+
+        template <r::viewable_range R>
+        requires r::input_range<R>
+        friend auto operator|(R &&rng, const closure &c) {
+            return prefetch_view{std::forward<R>(rng), c.depth};
+        }
+    };
+
+    constexpr closure operator()(std::size_t depth) const noexcept {
+        return {depth};
+    }
+
+    template <r::viewable_range R>
+    requires r::input_range<R>
+    friend auto operator|(R &&rng, const prefetch_fn &) {
+        return prefetch_view{std::forward<R>(rng)};
+    }
+};
+
+} // namespace detail
+
+inline detail::prefetch_fn prefetch;
+
+} // namespace cor3ntin::rangesnext
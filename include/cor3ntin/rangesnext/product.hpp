@@ -7,8 +7,12 @@ Licenced under Boost Software License. See LICENSE.md for details.
 #pragma once
 
 #include <cor3ntin/rangesnext/__detail.hpp>
+#include <cstddef>
+#include <memory>
 #include <ranges>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 namespace cor3ntin::rangesnext {
 
@@ -16,6 +20,14 @@ namespace r = std::ranges;
 
 namespace detail {
 
+template <std::size_t... I>
+constexpr auto reverse_indices(std::index_sequence<I...>) {
+    return std::index_sequence<(sizeof...(I) - 1 - I)...>{};
+}
+
+template <std::size_t N>
+using reverse_index_sequence = decltype(reverse_indices(std::make_index_sequence<N>{}));
+
 template <typename First, typename... R>
 constexpr bool valid_product_pack(r::input_range<First> &&
                                   (r::forward_range<R> && ...));
@@ -56,11 +68,11 @@ template <r::view... V>
         using difference_type = std::common_type_t<r::range_difference_t<V>...>;
 
         iterator() = default;
-        iterator(parent *view, r::iterator_t<V>... its)
+        constexpr iterator(parent *view, r::iterator_t<V>... its)
             : view_(view), its_(std::move(its)...) {
         }
 
-        auto operator*() const {
+        constexpr auto operator*() const {
             return std::apply(
                 [&](const auto &... args) { return result{*(args)...}; }, its_);
         }
@@ -107,19 +119,19 @@ template <r::view... V>
         friend constexpr iterator
         operator+(iterator i,
                   difference_type n) requires(r::random_access_range<V> &&...) {
-            return {i + n};
+            return i += n;
         }
 
         friend constexpr iterator
         operator+(difference_type n,
                   iterator i) requires(r::random_access_range<V> &&...) {
-            return {i + n};
+            return i += n;
         }
 
         friend constexpr iterator
         operator-(iterator i,
                   difference_type n) requires(r::random_access_range<V> &&...) {
-            return {i - n};
+            return i -= n;
         }
 
         friend constexpr difference_type
@@ -130,7 +142,7 @@ template <r::view... V>
 
         constexpr decltype(auto) operator[](difference_type n) const
             requires(r::random_access_range<V> &&...) {
-            return *iterator{*this + n};
+            return *(*this + n);
         }
 
         constexpr bool operator==(const iterator &other) const {
@@ -161,80 +173,84 @@ template <r::view... V>
             return std::end(v) == std::get<0>(its_);
         }
 
-        template <auto N = 0>
-        constexpr static auto compare(const iterator &a, const iterator &b)
-            -> std::strong_ordering {
-            auto cmp = std::get<N>(a.its_) <=> std::get<N>(b.its_);
-            if constexpr (N + 1 < sizeof...(V)) {
-                if (cmp == 0)
-                    return compare<N + 1>(a, b);
-            }
-            return cmp;
+        // The helpers below apply an operation to each iterator with a fold
+        // expression, rather than recursing on the index, which keeps the
+        // instantiation depth constant.
+        // reversed visits the last, fastest changing, iterator first.
+        using reversed = detail::reverse_index_sequence<sizeof...(V)>;
+
+        constexpr static auto compare(const iterator &a, const iterator &b) -> std::strong_ordering {
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                std::strong_ordering cmp = std::strong_ordering::equal;
+                (((cmp = std::get<I>(a.its_) <=> std::get<I>(b.its_)) == 0) && ...);
+                return cmp;
+            }(std::index_sequence_for<V...>{});
         }
 
-        template <auto N = sizeof...(V) - 1>
         constexpr static bool eq(const iterator &a, const iterator &b) {
-            if (std::get<N>(a.its_) != std::get<N>(b.its_)) {
-                return false;
-            }
-            if constexpr (N > 0) {
-                return eq<N - 1>(a, b);
-            }
-            return true;
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                return ((std::get<I>(a.its_) == std::get<I>(b.its_)) && ...);
+            }(reversed{});
         }
 
-        template <auto N = sizeof...(V) - 1>
-        constexpr void next() {
+        // Increments the N-th iterator, returns whether it wrapped around
+        template <std::size_t N>
+        constexpr bool increment() {
             const auto &v = std::get<N>(view_->bases_);
             auto &it = std::get<N>(its_);
-            if (++it ==
-                std::end(
-                    v)) { // TODO r::end doesn't compile for istream_view Bug ?
+            // TODO r::end doesn't compile for istream_view Bug ?
+            if (++it == std::end(v)) {
                 if constexpr (N != 0) {
                     it = r::begin(v);
-                    next<N - 1>();
+                    return true;
                 }
             }
+            return false;
         }
 
-        template <auto N = sizeof...(V) - 1>
-        constexpr void prev() {
+        constexpr void next() {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (increment<I>() && ...);
+            }(reversed{});
+        }
+
+        // Decrements the N-th iterator, returns whether it wrapped around
+        template <std::size_t N>
+        constexpr bool decrement() {
             const auto &v = std::get<N>(view_->bases_);
             auto &it = std::get<N>(its_);
-            if (it == r::begin(v)) {
+            const bool wrap = it == r::begin(v);
+            if (wrap)
                 r::advance(it, r::end(v));
-                if constexpr (N > 0)
-                    prev<N - 1>();
-            }
             --it;
+            return wrap && N != 0;
         }
 
-        template <std::size_t N = sizeof...(V) - 1>
-        constexpr difference_type distance(const iterator &other) const {
-            if constexpr (N == 0) {
-                return std::get<0>(other.its_) - std::get<0>(its_);
-            } else {
-                const auto d = this->distance<N - 1>(other);
-                auto const scale = r::distance(std::get<N>(view_->bases_));
-                auto const increment =
-                    std::get<N>(other.its_) - std::get<N>(its_);
-
-                return difference_type{(d * scale) + increment};
-            }
+        constexpr void prev() {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (decrement<I>() && ...);
+            }(reversed{});
         }
 
-        template <std::size_t N = sizeof...(V) - 1>
-        void advance(difference_type n) {
-            if (n == 0)
-                return;
+        constexpr difference_type distance(const iterator &other) const {
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                difference_type d = 0;
+                ((d = d * static_cast<difference_type>(I == 0 ? 1 : r::distance(std::get<I>(view_->bases_))) +
+                      static_cast<difference_type>(std::get<I>(other.its_) - std::get<I>(its_))),
+                 ...);
+                return d;
+            }(std::index_sequence_for<V...>{});
+        }
 
+        // Moves the N-th iterator by n, returns by how much
+        // the previous iterator must be moved
+        template <std::size_t N>
+        constexpr difference_type advance_one(difference_type n) {
             auto &i = std::get<N>(its_);
-            auto const size = static_cast<difference_type>(
-                r::size(std::get<N>(view_->bases_)));
+            auto const size = static_cast<difference_type>(r::size(std::get<N>(view_->bases_)));
             auto const first = r::begin(std::get<N>(view_->bases_));
 
-            auto const idx = static_cast<difference_type>(i - first);
-            n += idx;
+            n += static_cast<difference_type>(i - first);
 
             auto div = size ? n / size : 0;
             auto mod = size ? n % size : 0;
@@ -244,14 +260,21 @@ template <r::view... V>
                     mod += size;
                     div--;
                 }
-                advance<N - 1>(div);
             } else {
                 if (div > 0) {
                     mod = size;
                 }
+                div = 0;
             }
             using D = std::iter_difference_t<decltype(first)>;
             i = first + static_cast<D>(mod);
+            return div;
+        }
+
+        constexpr void advance(difference_type n) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((n != 0 && (n = advance_one<I>(n), true)) && ...);
+            }(reversed{});
         }
     };
 
@@ -331,12 +354,76 @@ template <r::view... V>
 template <typename... Rng>
 product_view(Rng &&...) -> product_view<r::views::all_t<Rng>...>;
 
+// A forward view over the elements of an input view.
+// The elements are copied into a contiguous buffer when the view is
+// constructed, iterations replay the buffer.
+// The buffer is shared and immutable: copies are O(1), and the view
+// can be iterated by several threads.
+// This lets single-pass ranges be used as inner ranges of product_view.
+template <r::view V, typename Alloc = std::allocator<r::range_value_t<V>>>
+requires r::input_range<V> class buffered_view : public r::view_interface<buffered_view<V, Alloc>> {
+
+    using value_type = r::range_value_t<V>;
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+    using buffer_type = std::vector<value_type, allocator_type>;
+    using iterator = typename buffer_type::const_iterator;
+
+    std::shared_ptr<const buffer_type> buffer_;
+
+  public:
+    buffered_view() = default;
+    explicit buffered_view(V base, const Alloc &alloc = Alloc()) : buffer_(fill(base, alloc)) {
+    }
+
+    iterator begin() const {
+        return buffer_ ? buffer_->cbegin() : iterator{};
+    }
+
+    iterator end() const {
+        return buffer_ ? buffer_->cend() : iterator{};
+    }
+
+    std::size_t size() const {
+        return buffer_ ? buffer_->size() : 0;
+    }
+
+  private:
+    static std::shared_ptr<const buffer_type> fill(V &base, const Alloc &alloc) {
+        auto buffer = std::make_shared<buffer_type>(allocator_type(alloc));
+        if constexpr (r::sized_range<V>) {
+            buffer->reserve(r::size(base));
+        }
+        for (auto it = r::begin(base); it != r::end(base); ++it) {
+            buffer->push_back(*it);
+        }
+        return buffer;
+    }
+};
+
 namespace detail {
 
 struct product_view_fn {
-    template <typename... R>
+    template <r::viewable_range... R>
     constexpr auto operator()(R &&... ranges) const {
-        return product_view{std::forward<R>(ranges)...};
+        return (*this)(std::allocator_arg, std::allocator<std::byte>{}, std::forward<R>(ranges)...);
+    }
+
+    // Inner input-only ranges are read into buffers, allocated with alloc,
+    // when the product is constructed
+    template <typename Alloc, r::viewable_range First, r::viewable_range... R>
+    constexpr auto operator()(std::allocator_arg_t, const Alloc &alloc, First &&first, R &&... rest) const {
+        return product_view{std::forward<First>(first), buffer_if_input(alloc, std::forward<R>(rest))...};
+    }
+
+  private:
+
+    template <typename Alloc, typename R>
+    static constexpr decltype(auto) buffer_if_input(const Alloc &alloc, R &&rng) {
+        if constexpr (r::forward_range<R>) {
+            return std::forward<R>(rng);
+        } else {
+            return buffered_view<r::views::all_t<R>, Alloc>{r::views::all(std::forward<R>(rng)), alloc};
+        }
     }
 };
 } // namespace detail
@@ -0,0 +1,238 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+// Anything shaped like std::extents
+template <typename E>
+concept extents_like = std::copyable<E> && std::integral<typename E::index_type> && requires(const E &e) {
+    { E::rank() } -> std::convertible_to<std::size_t>;
+    { e.extent(0) } -> std::convertible_to<typename E::index_type>;
+};
+
+} // namespace detail
+
+template <std::integral IndexType, std::size_t Rank>
+struct dynamic_extents {
+    using index_type = IndexType;
+    using rank_type = std::size_t;
+
+    std::array<index_type, Rank> extents_ = {};
+
+    static constexpr rank_type rank() noexcept {
+        return Rank;
+    }
+
+    constexpr index_type extent(rank_type r) const noexcept {
+        return extents_[r];
+    }
+};
+
+template <std::integral IndexType, std::size_t... Extents>
+struct static_extents {
+    using index_type = IndexType;
+    using rank_type = std::size_t;
+
+    static constexpr rank_type rank() noexcept {
+        return sizeof...(Extents);
+    }
+
+    static constexpr index_type extent(rank_type r) noexcept {
+        constexpr std::array<index_type, sizeof...(Extents)> e{Extents...};
+        return e[r];
+    }
+};
+
+// Equivalent to product(iota(0, n0), iota(0, n1), ...), yielding
+// std::array<index_type, rank>.
+// Iterators hold a plain index array with a carry on increment, and
+// compare on a linear index only, so iterating produces the same code
+// as nested for loops.
+template <detail::extents_like E>
+class product_indices_view : public r::view_interface<product_indices_view<E>> {
+  public:
+    using extents_type = E;
+    using index_type = typename E::index_type;
+    static constexpr std::size_t rank = E::rank();
+
+  private:
+    E extents_ = {};
+
+  public:
+    struct iterator {
+      private:
+        E extents_ = {};
+        std::array<index_type, rank> idx_ = {};
+        std::make_signed_t<index_type> linear_ = 0;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::array<index_type, rank>;
+        using reference = value_type;
+        using difference_type = std::make_signed_t<index_type>;
+
+        iterator() = default;
+
+        constexpr iterator(const E &extents, difference_type linear) : extents_(extents), linear_(linear) {
+            unrank();
+        }
+
+        constexpr value_type operator*() const {
+            return idx_;
+        }
+
+        constexpr const std::array<index_type, rank> &indices() const {
+            return idx_;
+        }
+
+        constexpr difference_type linear_index() const {
+            return linear_;
+        }
+
+        constexpr iterator &operator++() {
+            ++linear_;
+            for (std::size_t d = rank; d-- > 0;) {
+                if (++idx_[d] < extents_.extent(d))
+                    return *this;
+                idx_[d] = 0;
+            }
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator--() {
+            --linear_;
+            for (std::size_t d = rank; d-- > 0;) {
+                if (idx_[d]-- > 0)
+                    return *this;
+                idx_[d] = extents_.extent(d) - 1;
+            }
+            return *this;
+        }
+
+        constexpr iterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        constexpr iterator &operator+=(difference_type n) {
+            linear_ += n;
+            unrank();
+            return *this;
+        }
+
+        constexpr iterator &operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator+(difference_type n, iterator i) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator-(iterator i, difference_type n) {
+            return i -= n;
+        }
+
+        friend constexpr difference_type operator-(const iterator &x, const iterator &y) {
+            return x.linear_ - y.linear_;
+        }
+
+        constexpr value_type operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        friend constexpr bool operator==(const iterator &x, const iterator &y) {
+            return x.linear_ == y.linear_;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(const iterator &x, const iterator &y) {
+            return x.linear_ <=> y.linear_;
+        }
+
+      private:
+        // The past-the-end position wraps around to all zeros,
+        // like an increment from the last element does.
+        constexpr void unrank() {
+            auto l = static_cast<index_type>(linear_);
+            for (std::size_t d = rank; d-- > 0;) {
+                const auto e = extents_.extent(d);
+                if (e == 0)
+                    return;
+                idx_[d] = l % e;
+                l /= e;
+            }
+        }
+    };
+
+    constexpr product_indices_view() = default;
+    constexpr explicit product_indices_view(E extents) : extents_(std::move(extents)) {
+    }
+
+    constexpr iterator begin() const {
+        return iterator(extents_, 0);
+    }
+
+    constexpr iterator end() const {
+        return iterator(extents_, static_cast<typename iterator::difference_type>(size()));
+    }
+
+    constexpr auto size() const {
+        std::make_unsigned_t<index_type> s = 1;
+        for (std::size_t d = 0; d < rank; ++d)
+            s *= static_cast<std::make_unsigned_t<index_type>>(extents_.extent(d));
+        return s;
+    }
+
+    constexpr const E &extents() const {
+        return extents_;
+    }
+};
+
+namespace detail {
+
+struct product_indices_fn {
+    template <extents_like E>
+    constexpr auto operator()(E extents) const {
+        return product_indices_view<E>{std::move(extents)};
+    }
+
+    template <std::integral... I>
+    requires(sizeof...(I) > 0) constexpr auto operator()(I... n) const {
+        using index_type = std::common_type_t<I...>;
+        using E = dynamic_extents<index_type, sizeof...(I)>;
+        return product_indices_view<E>{E{{static_cast<index_type>(n)...}}};
+    }
+};
+
+} // namespace detail
+
+inline detail::product_indices_fn product_indices;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,275 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <array>
+#include <compare>
+#include <cor3ntin/rangesnext/__detail.hpp>
+#include <cstdint>
+#include <random>
+#include <ranges>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+// A pseudorandom bijection of [0, size).
+// A balanced Feistel network permutes the smallest power of 4 >= size,
+// values falling outside of [0, size) are re-encrypted until they land in it
+// (cycle walking), which takes less than 4 rounds on average.
+class index_permutation {
+    std::uint64_t size_ = 0;
+    unsigned half_bits_ = 0;
+    std::uint64_t mask_ = 0;
+    std::array<std::uint64_t, 4> keys_ = {};
+
+  public:
+    constexpr index_permutation() = default;
+    constexpr index_permutation(std::uint64_t size, std::array<std::uint64_t, 4> keys)
+        : size_(size), keys_(keys) {
+        unsigned bits = 0;
+        while (bits < 64 && (std::uint64_t(1) << bits) < size)
+            ++bits;
+        half_bits_ = (bits + 1) / 2;
+        mask_ = (std::uint64_t(1) << half_bits_) - 1;
+    }
+
+    constexpr std::uint64_t operator()(std::uint64_t i) const {
+        do {
+            i = encrypt(i);
+        } while (i >= size_);
+        return i;
+    }
+
+  private:
+    static constexpr std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    constexpr std::uint64_t encrypt(std::uint64_t x) const {
+        std::uint64_t left = x >> half_bits_;
+        std::uint64_t right = x & mask_;
+        for (auto key : keys_) {
+            const std::uint64_t tmp = left ^ (mix(right ^ key) & mask_);
+            left = right;
+            right = tmp;
+        }
+        return (left << half_bits_) | right;
+    }
+};
+
+inline constexpr std::array<std::uint64_t, 4> default_permutation_keys = {
+    0x243f6a8885a308d3, 0x13198a2e03707344, 0xa4093822299f31d0, 0x082efa98ec4e6c89};
+
+template <typename URBG>
+std::array<std::uint64_t, 4> permutation_keys(URBG &&g) {
+    std::uniform_int_distribution<std::uint64_t> dist;
+    std::array<std::uint64_t, 4> keys;
+    for (auto &k : keys)
+        k = dist(g);
+    return keys;
+}
+
+} // namespace detail
+
+// Visits every element of a sized random access view exactly once,
+// in a pseudorandom order.
+// Elements are reached by advancing an iterator to a permuted position,
+// so memory usage does not depend on the size of the view.
+template <r::view V>
+requires r::random_access_range<V> && r::sized_range<V>
+class random_order_view : public r::view_interface<random_order_view<V>> {
+
+    V base_ = {};
+    detail::index_permutation permutation_;
+
+  public:
+    template <bool Const>
+    struct iterator {
+      private:
+        using parent = std::conditional_t<Const, const random_order_view, random_order_view>;
+        using Base = std::conditional_t<Const, const V, V>;
+
+        parent *view_ = nullptr;
+        r::range_difference_t<Base> pos_ = 0;
+
+        template <bool>
+        friend struct iterator;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using reference = r::range_reference_t<Base>;
+        using value_type = r::range_value_t<Base>;
+        using difference_type = r::range_difference_t<Base>;
+
+        iterator() = default;
+
+        constexpr iterator(parent *view, difference_type pos) : view_(view), pos_(pos) {
+        }
+
+        constexpr iterator(iterator<!Const> i) requires Const
+            && std::convertible_to<r::iterator_t<V>, r::iterator_t<Base>> : view_(i.view_), pos_(i.pos_) {
+        }
+
+        // The position of the current element in the underlying view
+        constexpr difference_type index() const {
+            return static_cast<difference_type>(view_->permutation_(static_cast<std::uint64_t>(pos_)));
+        }
+
+        constexpr decltype(auto) operator*() const {
+            return r::begin(view_->base_)[index()];
+        }
+
+        constexpr iterator &operator++() {
+            ++pos_;
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++pos_;
+            return tmp;
+        }
+
+        constexpr iterator &operator--() {
+            --pos_;
+            return *this;
+        }
+
+        constexpr iterator operator--(int) {
+            auto tmp = *this;
+            --pos_;
+            return tmp;
+        }
+
+        constexpr iterator &operator+=(difference_type n) {
+            pos_ += n;
+            return *this;
+        }
+
+        constexpr iterator &operator-=(difference_type n) {
+            pos_ -= n;
+            return *this;
+        }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator+(difference_type n, iterator i) {
+            return i += n;
+        }
+
+        friend constexpr iterator operator-(iterator i, difference_type n) {
+            return i -= n;
+        }
+
+        friend constexpr difference_type operator-(const iterator &x, const iterator &y) {
+            return x.pos_ - y.pos_;
+        }
+
+        constexpr decltype(auto) operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        friend constexpr bool operator==(const iterator &x, const iterator &y) {
+            return x.pos_ == y.pos_;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(const iterator &x, const iterator &y) {
+            return x.pos_ <=> y.pos_;
+        }
+    };
+
+    constexpr random_order_view() = default;
+    constexpr random_order_view(V base, std::array<std::uint64_t, 4> keys = detail::default_permutation_keys)
+        : base_(std::move(base)), permutation_(static_cast<std::uint64_t>(r::size(base_)), keys) {
+    }
+
+    constexpr auto begin() requires(!detail::simple_view<V>) {
+        return iterator<false>(this, 0);
+    }
+
+    constexpr auto begin() const requires r::random_access_range<const V> && r::sized_range<const V> {
+        return iterator<true>(this, 0);
+    }
+
+    constexpr auto end() requires(!detail::simple_view<V>) {
+        return iterator<false>(this, static_cast<r::range_difference_t<V>>(size()));
+    }
+
+    constexpr auto end() const requires r::random_access_range<const V> && r::sized_range<const V> {
+        return iterator<true>(this, static_cast<r::range_difference_t<V>>(size()));
+    }
+
+    constexpr auto size() const {
+        return r::size(base_);
+    }
+
+    constexpr V base() const &requires std::copyable<V> {
+        return base_;
+    }
+
+    constexpr V base() && {
+        return std::move(base_);
+    }
+};
+
+template <typename R>
+random_order_view(R &&) -> random_order_view<r::views::all_t<R>>;
+
+template <typename R>
+random_order_view(R &&, std::array<std::uint64_t, 4>) -> random_order_view<r::views::all_t<R>>;
+
+namespace detail {
+
+struct random_order_view_fn {
+    template <r::viewable_range R>
+    requires r::random_access_range<R> && r::sized_range<R>
+    constexpr auto operator()(R &&rng) const {
+        return random_order_view{std::forward<R>(rng)};
+    }
+
+    template <r::viewable_range R, typename URBG>
+    requires r::random_access_range<R> && r::sized_range<R> &&
+        std::uniform_random_bit_generator<std::remove_cvref_t<URBG>>
+    auto operator()(R &&rng, URBG &&g) const {
+        return random_order_view{std::forward<R>(rng), permutation_keys(g)};
+    }
+
+    template <r::viewable_range R>
+    requires r::random_access_range<R> && r::sized_range<R>
+    constexpr friend auto operator|(R &&rng, const random_order_view_fn &) {
+        return random_order_view{std::forward<R>(rng)};
+    }
+};
+
+struct sample_fn {
+    // The first k elements of a random_order of rng: k distinct elements,
+    // pseudorandom but not uniformly distributed among the k-subsets,
+    // since a keyed permutation can only reach a few of the n! orders
+    template <r::viewable_range R, typename URBG>
+    requires r::random_access_range<R> && r::sized_range<R> &&
+        std::uniform_random_bit_generator<std::remove_cvref_t<URBG>>
+    auto operator()(R &&rng, r::range_difference_t<R> k, URBG &&g) const {
+        return random_order_view{std::forward<R>(rng), permutation_keys(g)} | r::views::take(k);
+    }
+};
+
+} // namespace detail
+
+inline detail::random_order_view_fn random_order;
+inline detail::sample_fn sample;
+
+} // namespace cor3ntin::rangesnext
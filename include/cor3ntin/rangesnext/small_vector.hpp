@@ -0,0 +1,459 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cor3ntin/rangesnext/to.hpp>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+namespace detail {
+
+struct no_heap {};
+
+// A vector storing up to N elements in the object itself.
+// When Growable, larger sizes move the elements to the heap,
+// otherwise exceeding N throws std::length_error.
+template <typename T, std::size_t N, bool Growable>
+class inline_vector {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    inline_vector() noexcept {
+        if constexpr (Growable)
+            m_capacity = N;
+    }
+
+    explicit inline_vector(size_type n) : inline_vector() {
+        resize(n);
+    }
+
+    inline_vector(size_type n, const T &value) : inline_vector() {
+        resize(n, value);
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    inline_vector(It first, S last) : inline_vector() {
+        append(first, last);
+    }
+
+    inline_vector(std::initializer_list<T> values) : inline_vector(values.begin(), values.end()) {
+    }
+
+    template <std::ranges::input_range R>
+    requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+    inline_vector(from_range_t, R &&rng) : inline_vector() {
+        append(std::ranges::begin(rng), std::ranges::end(rng));
+    }
+
+    inline_vector(const inline_vector &other) : inline_vector(other.begin(), other.end()) {
+    }
+
+    inline_vector(inline_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) : inline_vector() {
+        steal(other);
+    }
+
+    ~inline_vector() {
+        std::destroy(begin(), end());
+        if constexpr (Growable) {
+            if (!is_inline())
+                std::allocator<T>().deallocate(m_heap, m_capacity);
+        }
+    }
+
+    inline_vector &operator=(const inline_vector &other) {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    inline_vector &operator=(inline_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    inline_vector &operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    void assign(It first, S last) {
+        clear();
+        append(first, last);
+    }
+
+    iterator begin() noexcept {
+        return data();
+    }
+    const_iterator begin() const noexcept {
+        return data();
+    }
+    const_iterator cbegin() const noexcept {
+        return data();
+    }
+    iterator end() noexcept {
+        return data() + m_size;
+    }
+    const_iterator end() const noexcept {
+        return data() + m_size;
+    }
+    const_iterator cend() const noexcept {
+        return data() + m_size;
+    }
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    T *data() noexcept {
+        if constexpr (Growable)
+            return is_inline() ? inline_data() : m_heap;
+        else
+            return inline_data();
+    }
+
+    const T *data() const noexcept {
+        return const_cast<inline_vector *>(this)->data();
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    size_type capacity() const noexcept {
+        if constexpr (Growable)
+            return m_capacity;
+        else
+            return N;
+    }
+
+    size_type max_size() const noexcept {
+        if constexpr (Growable)
+            return std::allocator_traits<std::allocator<T>>::max_size(std::allocator<T>());
+        else
+            return N;
+    }
+
+    // Whether the elements are stored in the object.
+    // Heap buffers are always larger than N.
+    bool is_inline() const noexcept {
+        if constexpr (Growable)
+            return m_capacity == N;
+        else
+            return true;
+    }
+
+    T &operator[](size_type i) noexcept {
+        return data()[i];
+    }
+    const T &operator[](size_type i) const noexcept {
+        return data()[i];
+    }
+
+    T &at(size_type i) {
+        if (i >= m_size)
+            throw std::out_of_range("inline_vector::at");
+        return data()[i];
+    }
+    const T &at(size_type i) const {
+        if (i >= m_size)
+            throw std::out_of_range("inline_vector::at");
+        return data()[i];
+    }
+
+    T &front() noexcept {
+        return data()[0];
+    }
+    const T &front() const noexcept {
+        return data()[0];
+    }
+    T &back() noexcept {
+        return data()[m_size - 1];
+    }
+    const T &back() const noexcept {
+        return data()[m_size - 1];
+    }
+
+    void reserve(size_type n) {
+        if (n <= capacity())
+            return;
+        if constexpr (Growable)
+            reallocate(n);
+        else
+            throw std::length_error("static_vector: capacity exceeded");
+    }
+
+    void clear() noexcept {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args) {
+        if (m_size == capacity()) {
+            // args may refer to an element, construct before reallocating
+            T value(std::forward<Args>(args)...);
+            grow(m_size + 1);
+            std::construct_at(end(), std::move(value));
+        } else {
+            std::construct_at(end(), std::forward<Args>(args)...);
+        }
+        ++m_size;
+        return back();
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept {
+        std::destroy_at(&back());
+        --m_size;
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args &&...args) {
+        const auto index = static_cast<size_type>(pos - begin());
+        if (index == m_size) {
+            emplace_back(std::forward<Args>(args)...);
+            return begin() + index;
+        }
+        T value(std::forward<Args>(args)...);
+        if (m_size == capacity())
+            grow(m_size + 1);
+        std::construct_at(end(), std::move(back()));
+        ++m_size;
+        std::move_backward(begin() + index, end() - 2, end() - 1);
+        data()[index] = std::move(value);
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator pos, const T &value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T &&value) {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto f = begin() + (first - begin());
+        const auto l = begin() + (last - begin());
+        if (f != l) {
+            auto new_end = std::move(l, end(), f);
+            std::destroy(new_end, end());
+            m_size = static_cast<size_type>(new_end - begin());
+        }
+        return f;
+    }
+
+    void resize(size_type n) {
+        resize_impl(n, [](T *p) { std::uninitialized_value_construct_n(p, 1); });
+    }
+
+    void resize(size_type n, const T &value) {
+        resize_impl(n, [&](T *p) { std::construct_at(p, value); });
+    }
+
+    void swap(inline_vector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (Growable) {
+            if (!is_inline() && !other.is_inline()) {
+                std::swap(m_heap, other.m_heap);
+                std::swap(m_capacity, other.m_capacity);
+                std::swap(m_size, other.m_size);
+                return;
+            }
+        }
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(m_inline) <= trivial_copy_limit) {
+            if (is_inline() && other.is_inline()) {
+                std::byte tmp[sizeof(m_inline)];
+                std::memcpy(tmp, m_inline, sizeof(m_inline));
+                std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+                std::memcpy(other.m_inline, tmp, sizeof(m_inline));
+                std::swap(m_size, other.m_size);
+                return;
+            }
+        }
+        inline_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(inline_vector &a, inline_vector &b) noexcept(noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    friend bool operator==(const inline_vector &a, const inline_vector &b) requires std::equality_comparable<T> {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend auto operator<=>(const inline_vector &a, const inline_vector &b) requires std::three_way_comparable<T> {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+  private:
+    // Inline buffers of trivial types up to this size are copied as a whole
+    static constexpr std::size_t trivial_copy_limit = 256;
+
+    T *inline_data() noexcept {
+        return std::launder(reinterpret_cast<T *>(m_inline));
+    }
+
+    template <typename It, typename S>
+    void append(It first, S last) {
+        if constexpr (std::forward_iterator<It> && std::sized_sentinel_for<S, It>) {
+            // copied at once, which is a memmove for trivial types
+            const auto n = static_cast<size_type>(last - first);
+            reserve(m_size + n);
+            std::ranges::uninitialized_copy_n(first, n, end(), end() + n);
+            m_size += n;
+        } else {
+            if constexpr (std::sized_sentinel_for<S, It>)
+                reserve(m_size + static_cast<size_type>(last - first));
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+    }
+
+    template <typename F>
+    void resize_impl(size_type n, F construct) {
+        if (n <= m_size) {
+            std::destroy(begin() + n, end());
+            m_size = n;
+            return;
+        }
+        reserve(n);
+        while (m_size < n) {
+            construct(end());
+            ++m_size;
+        }
+    }
+
+    void grow(size_type n) {
+        if constexpr (Growable)
+            reallocate(std::max(n, capacity() * 2));
+        else
+            throw std::length_error("static_vector: capacity exceeded");
+    }
+
+    void reallocate(size_type n) requires Growable {
+        std::allocator<T> alloc;
+        T *p = alloc.allocate(n);
+        try {
+            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                std::uninitialized_move(begin(), end(), p);
+            else
+                std::uninitialized_copy(begin(), end(), p);
+        } catch (...) {
+            alloc.deallocate(p, n);
+            throw;
+        }
+        std::destroy(begin(), end());
+        release();
+        m_heap = p;
+        m_capacity = n;
+    }
+
+    // Frees the heap buffer, if any, the elements must have been destroyed
+    void release() noexcept {
+        if constexpr (Growable) {
+            if (!is_inline())
+                std::allocator<T>().deallocate(m_heap, m_capacity);
+            m_capacity = N;
+        }
+    }
+
+    // Takes the elements of other, which is left empty.
+    // *this must be empty and inline.
+    void steal(inline_vector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (Growable) {
+            if (!other.is_inline()) {
+                m_heap = other.m_heap;
+                m_capacity = std::exchange(other.m_capacity, N);
+                m_size = std::exchange(other.m_size, 0);
+                return;
+            }
+        }
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(m_inline) <= trivial_copy_limit) {
+            // a fixed size copy of the whole buffer is cheaper than a loop
+            std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+        } else {
+            std::uninitialized_move(other.begin(), other.end(), inline_data());
+        }
+        m_size = other.m_size;
+        other.clear();
+    }
+
+    // The heap buffer, only set when the capacity is larger than N: an inline
+    // vector doesn't point to itself, so moving it doesn't store a pointer
+    [[no_unique_address]] std::conditional_t<Growable, T *, no_heap> m_heap;
+    size_type m_size = 0;
+    [[no_unique_address]] std::conditional_t<Growable, size_type, no_heap> m_capacity;
+    alignas(T) std::byte m_inline[sizeof(T) * (N == 0 ? 1 : N)];
+};
+
+} // namespace detail
+
+// A vector storing up to N elements without allocating,
+// larger vectors store their elements on the heap.
+template <typename T, std::size_t N>
+using small_vector = detail::inline_vector<T, N, true>;
+
+// A vector of at most N elements, stored in the object.
+// Exceeding N throws std::length_error.
+template <typename T, std::size_t N>
+using static_vector = detail::inline_vector<T, N, false>;
+
+} // namespace cor3ntin::rangesnext
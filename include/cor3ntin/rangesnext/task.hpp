@@ -0,0 +1,179 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+Copyright (c) 2017 - present Lewis Baker
+
+This code has been adapted from cppcoro
+https://github.com/lewissbaker/cppcoro
+
+Licenced under Boost Software License license.
+See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace cor3ntin::rangesnext {
+
+template <typename T = void>
+class task;
+
+class event_loop;
+
+namespace detail {
+
+class task_promise_base {
+  public:
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    // Resumes the awaiting coroutine, if any
+    auto final_suspend() const noexcept {
+        return final_awaiter{};
+    }
+
+    void unhandled_exception() noexcept {
+        m_exception = std::current_exception();
+    }
+
+    void set_continuation(std::coroutine_handle<> continuation) noexcept {
+        m_continuation = continuation;
+    }
+
+  protected:
+    void rethrow_if_exception() {
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+  private:
+    struct final_awaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            return h.promise().m_continuation;
+        }
+        void await_resume() const noexcept {
+        }
+    };
+
+    std::coroutine_handle<> m_continuation = std::noop_coroutine();
+    std::exception_ptr m_exception;
+};
+
+template <typename T>
+class task_promise : public task_promise_base {
+  public:
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    requires std::convertible_to<U &&, T>
+    void return_value(U &&value) {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result() {
+        rethrow_if_exception();
+        return std::move(*m_value);
+    }
+
+  private:
+    std::optional<T> m_value;
+};
+
+template <>
+class task_promise<void> : public task_promise_base {
+  public:
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {
+    }
+
+    void result() {
+        rethrow_if_exception();
+    }
+};
+
+} // namespace detail
+
+// A lazily started coroutine producing a T.
+// Awaiting a task starts it, the awaiting coroutine is resumed
+// when the task completes.
+template <typename T>
+class [[nodiscard]] task {
+  public:
+    using promise_type = detail::task_promise<T>;
+
+    task() = default;
+
+    task(task &&other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {
+    }
+
+    task(const task &) = delete;
+
+    ~task() {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+        }
+    }
+
+    task &operator=(task &&other) noexcept {
+        std::swap(m_coroutine, other.m_coroutine);
+        return *this;
+    }
+
+    bool is_ready() const noexcept {
+        return !m_coroutine || m_coroutine.done();
+    }
+
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> coroutine;
+
+            bool await_ready() const noexcept {
+                return !coroutine || coroutine.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                coroutine.promise().set_continuation(awaiting);
+                return coroutine;
+            }
+
+            T await_resume() {
+                return coroutine.promise().result();
+            }
+        };
+        return awaiter{m_coroutine};
+    }
+
+  private:
+    friend promise_type;
+    friend event_loop;
+
+    explicit task(std::coroutine_handle<promise_type> coroutine) noexcept : m_coroutine(coroutine) {
+    }
+
+    std::coroutine_handle<promise_type> m_coroutine = nullptr;
+};
+
+namespace detail {
+
+template <typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>{std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>{std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cor3ntin::rangesnext {
+
+// A fixed set of worker threads, each with its own queue of tasks.
+// Tasks submitted by a worker go to its own queue, which it runs in LIFO
+// order, idle workers steal the oldest tasks of the other queues.
+class thread_pool {
+  public:
+    explicit thread_pool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+        threads = std::max(1u, threads);
+        for (unsigned i = 0; i < threads; ++i)
+            m_queues.push_back(std::make_unique<queue>());
+        for (unsigned i = 0; i < threads; ++i)
+            m_threads.emplace_back([this, i](std::stop_token token) { work(i, token); });
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    // Stops the workers, tasks which did not start are dropped
+    ~thread_pool() {
+        m_threads.clear();
+    }
+
+    // A pool with one thread per core, created on first use
+    static thread_pool &default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    unsigned size() const noexcept {
+        return static_cast<unsigned>(m_queues.size());
+    }
+
+    void submit(std::function<void()> task) {
+        auto &q = *m_queues[local_index().value_or(m_next.fetch_add(1, std::memory_order_relaxed) % size())];
+        m_queued.fetch_add(1, std::memory_order_release);
+        {
+            std::scoped_lock lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        {
+            std::scoped_lock lock(m_mutex);
+        }
+        m_wakeup.notify_one();
+    }
+
+    // Runs a pending task, if any, on the calling thread.
+    // Threads waiting for the completion of tasks should call it
+    // instead of blocking.
+    bool try_run_one() {
+        std::function<void()> task;
+        if (!pop(task))
+            return false;
+        task();
+        return true;
+    }
+
+  private:
+    struct queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct worker_identity {
+        const thread_pool *pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static worker_identity &identity() noexcept {
+        thread_local worker_identity id;
+        return id;
+    }
+
+    std::optional<std::size_t> local_index() const noexcept {
+        const auto &id = identity();
+        if (id.pool == this)
+            return id.index;
+        return std::nullopt;
+    }
+
+    bool pop(std::function<void()> &task) {
+        if (m_queued.load(std::memory_order_acquire) == 0)
+            return false;
+        const auto local = local_index();
+        if (local) {
+            auto &q = *m_queues[*local];
+            std::scoped_lock lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const std::size_t start = local ? *local + 1 : 0;
+        for (std::size_t i = 0; i < m_queues.size(); ++i) {
+            auto &q = *m_queues[(start + i) % m_queues.size()];
+            std::scoped_lock lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(std::size_t index, std::stop_token token) {
+        identity() = {this, index};
+        while (!token.stop_requested()) {
+            if (try_run_one())
+                continue;
+            std::unique_lock lock(m_mutex);
+            m_wakeup.wait(lock, token, [this] { return m_queued.load(std::memory_order_acquire) != 0; });
+        }
+    }
+
+    std::vector<std::unique_ptr<queue>> m_queues;
+    std::atomic<std::size_t> m_queued = 0;
+    std::atomic<std::size_t> m_next = 0;
+    std::mutex m_mutex;
+    std::condition_variable_any m_wakeup;
+    std::vector<std::jthread> m_threads;
+};
+
+} // namespace cor3ntin::rangesnext
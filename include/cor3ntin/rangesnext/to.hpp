@@ -6,16 +6,30 @@ Licenced under Boost Software License license. See LICENSE.md for details.
 
 #pragma once
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <iterator>
+#include <optional>
 #include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace cor3ntin::rangesnext {
 
 struct from_range_t {};
 inline constexpr from_range_t from_range;
 
+// Passed to `to` (or to the constructors of flat containers), indicates that
+// the range is sorted according to the comparator of the container,
+// and has no duplicates
+struct sorted_unique_t {};
+inline constexpr sorted_unique_t sorted_unique;
+
 namespace detail {
 
 namespace r = std::ranges;
@@ -67,7 +81,8 @@ struct container_value<C> {
     using type = r::range_value_t<C>;
 };
 template <typename C>
-requires(!requires { typename r::range_value_t<C>; }) struct container_value<C> {
+requires(!requires { typename r::range_value_t<C>; } && requires { typename C::value_type; })
+struct container_value<C> {
     using type = typename C::value_type;
 };
 
@@ -78,18 +93,116 @@ template <class C, class R>
 concept container_convertible =
     !r::view<C> && r::input_range<R> && std::convertible_to<r::range_reference_t<R>, container_value_t<C>>;
 
+// Whether R can be converted to C, converting nested ranges to the value
+// type of C recursively. This is a function rather than a disjunction of
+// concepts so that the checks stop at the first level which is convertible.
+template <class C, class R>
+consteval bool is_recursive_container_convertible() {
+    if constexpr (container_convertible<C, R>)
+        return true;
+    else if constexpr (!r::view<C> && r::input_range<R> && r::input_range<r::range_reference_t<R>> &&
+                       requires { typename container_value_t<C>; })
+        return is_recursive_container_convertible<container_value_t<C>, r::range_reference_t<R>>();
+    else
+        return false;
+}
+
+template <class C, class R>
+concept recursive_container_convertible = is_recursive_container_convertible<C, R>();
+
+// Returned by group_by: the key and the value of each element
+template <typename KeyFn, typename ValueFn>
+struct group_by_fn {
+    [[no_unique_address]] KeyFn key_fn;
+    [[no_unique_address]] ValueFn value_fn;
+};
+
+template <typename T>
+inline constexpr bool is_group_by_fn = false;
+
+template <typename KeyFn, typename ValueFn>
+inline constexpr bool is_group_by_fn<group_by_fn<KeyFn, ValueFn>> = true;
+
+template <typename... Args>
+inline constexpr bool starts_with_group_by = false;
+
+template <typename G, typename... Args>
+inline constexpr bool starts_with_group_by<G, Args...> = is_group_by_fn<std::remove_cvref_t<G>>;
+
+// C maps the keys of the elements of R to containers of their values
+template <class C, class R, class G>
+concept grouping_container_convertible =
+    r::input_range<R> && requires(C &c, typename C::mapped_type &group, G &g, r::range_reference_t<R> e) {
+    c.try_emplace(typename C::key_type(std::invoke(g.key_fn, e)));
+    group.insert(group.end(), std::invoke(g.value_fn, e));
+};
+
+template <class C, class R, class... Args>
+inline constexpr bool is_grouping_convertible = false;
+
+template <class C, class R, class G, class... Args>
+requires is_group_by_fn<std::remove_cvref_t<G>>
+inline constexpr bool is_grouping_convertible<C, R, G, Args...> =
+    grouping_container_convertible<C, R, std::remove_cvref_t<G>>;
+
+template <typename T>
+concept string_container = requires {
+    typename T::traits_type;
+} && requires(T &s, const typename T::value_type *p) {
+    s.append(p, s.size());
+    s.reserve(s.size());
+};
+
+// R is a range of strings, string views or character arrays, which are
+// concatenated into the string C
 template <class C, class R>
-concept recursive_container_convertible = container_convertible<C, R> ||
-    (r::input_range<r::range_reference_t<R>> &&requires {
-        {
-            to<r::range_value_t<C>>(std::declval<r::range_reference_t<R>>())
-            } -> std::convertible_to<r::range_value_t<C>>;
-    });
+concept joined_string_convertible =
+    string_container<C> && r::input_range<R> &&
+    std::convertible_to<r::range_reference_t<R>, std::basic_string_view<typename C::value_type, typename C::traits_type>>;
+
+// Whether to<C>(R, Args...) is valid
+template <class C, class R, class... Args>
+concept to_convertible = recursive_container_convertible<C, R> || is_grouping_convertible<C, R, Args...> ||
+                         joined_string_convertible<C, R>;
+
+// Appends the elements of rng to a String constructed from args, separated by sep.
+// The total length of forward ranges of existing strings is computed first,
+// so that the string is allocated once; other ranges grow it geometrically.
+template <typename String, typename Rng, typename... Args>
+constexpr String join_strings(Rng &&rng,
+                              std::basic_string_view<typename String::value_type, typename String::traits_type> sep,
+                              Args &&...args) {
+    using view_t = std::basic_string_view<typename String::value_type, typename String::traits_type>;
+    using reference = r::range_reference_t<Rng>;
+    String s(std::forward<Args>(args)...);
+    // prvalue strings (from a transform for example) would be produced twice
+    if constexpr (r::forward_range<Rng> && (std::is_lvalue_reference_v<reference> ||
+                                            std::is_trivially_copyable_v<std::remove_cvref_t<reference>>)) {
+        std::size_t size = 0;
+        std::size_t count = 0;
+        for (auto &&e : rng) {
+            size += view_t(e).size();
+            ++count;
+        }
+        if (count > 1)
+            size += sep.size() * (count - 1);
+        s.reserve(s.size() + size);
+    }
+    bool first = true;
+    for (auto &&e : rng) {
+        if (!first)
+            s.append(sep.data(), sep.size());
+        first = false;
+        const view_t v(e);
+        s.append(v.data(), v.size());
+    }
+    return s;
+}
 
 } // namespace detail
 
 template <typename Cont, std::ranges::input_range Rng, typename... Args>
-requires detail::recursive_container_convertible<Cont, Rng>
+requires detail::to_convertible<Cont, Rng, Args...>
 constexpr auto to(Rng &&rng, Args &&...args) -> Cont;
 
 namespace detail {
@@ -113,6 +226,29 @@ struct unwrap<wrap<Cont>, Rng, Args...> {
     using type = std::remove_cvref_t<std::remove_pointer_t<decltype(from_rng<Rng>(0))>>;
 };
 
+// The container type is deduced without the sorted_unique tag
+template <template <class...> class Cont, typename Rng, typename Tag, typename... Args>
+requires std::same_as<std::remove_cvref_t<Tag>, sorted_unique_t>
+struct unwrap<wrap<Cont>, Rng, Tag, Args...> : unwrap<wrap<Cont>, Rng, Args...> {};
+
+// Grouping deduces Cont<Key, std::vector<Value>>, as if constructed from such pairs
+template <template <class...> class Cont, typename Rng, typename G, typename... Args>
+requires is_group_by_fn<std::remove_cvref_t<G>>
+struct unwrap<wrap<Cont>, Rng, G, Args...> {
+    using key_fn_t = decltype((std::declval<std::remove_cvref_t<G> &>().key_fn));
+    using value_fn_t = decltype((std::declval<std::remove_cvref_t<G> &>().value_fn));
+    using key_t = std::remove_cvref_t<std::invoke_result_t<key_fn_t, r::range_reference_t<Rng>>>;
+    using value_t = std::remove_cvref_t<std::invoke_result_t<value_fn_t, r::range_reference_t<Rng>>>;
+
+    using type = typename unwrap<wrap<Cont>, std::vector<std::pair<key_t, std::vector<value_t>>>, Args...>::type;
+};
+
+template <typename... Args>
+inline constexpr bool starts_with_sorted_unique = false;
+
+template <typename Tag, typename... Args>
+inline constexpr bool starts_with_sorted_unique<Tag, Args...> = std::same_as<std::remove_cvref_t<Tag>, sorted_unique_t>;
+
 template <typename T>
 concept reservable_container = requires(T &c) {
     c.reserve(r::size(c));
@@ -120,11 +256,84 @@ concept reservable_container = requires(T &c) {
     {c.max_size()} -> std::same_as<decltype(r::size(c))>;
 };
 
+// Unordered containers have no capacity, but reserve buckets
+// for a number of elements, avoiding rehashes while they are inserted
+template <typename T>
+concept bucket_reservable_container = requires(T &c) {
+    c.reserve(r::size(c));
+    c.bucket_count();
+    c.max_load_factor();
+};
+
+template <typename T>
+concept presizable_container = reservable_container<T> || bucket_reservable_container<T>;
+
+// Ranges which are not sized, but may know how many elements they
+// will produce, like generators announcing a size_hint.
+// to calls size_hint() right before iterating the range: for a generator,
+// this runs the coroutine up to its first element.
+template <typename R>
+concept size_hinted_range = requires(R &rng) {
+    {rng.size_hint()} -> std::convertible_to<std::optional<std::size_t>>;
+};
+
+template <typename T>
+inline constexpr bool is_std_array = false;
+
+template <typename T, std::size_t N>
+inline constexpr bool is_std_array<std::array<T, N>> = true;
+
+// Initializes each element of the array from an element of rng, which must
+// have exactly as many elements. Usable in constant expressions.
+template <typename Array, typename Rng>
+constexpr Array to_std_array(Rng &&rng) {
+    using T = typename Array::value_type;
+    auto it = r::begin(rng);
+    auto last = r::end(rng);
+    auto next = [&] {
+        if (it == last)
+            throw std::length_error("to: the range is smaller than the array");
+        T value(*it);
+        ++it;
+        return value;
+    };
+    Array res = [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return Array{{(void(I), next())...}};
+    }(std::make_index_sequence<std::tuple_size_v<Array>>());
+    if (it != last)
+        throw std::length_error("to: the range is larger than the array");
+    return res;
+}
+
 template <typename T>
 concept insertable_container = requires(T &c, T::value_type &e) {
     c.insert(c.end(), e);
 };
 
+// Whether the iterators of Rng are forward iterators for the standard library.
+// Views producing prvalues, like transform, only have input iterators,
+// from which containers can't allocate their storage at once.
+template <typename Rng>
+concept legacy_forward_range = requires {
+    typename std::iterator_traits<r::iterator_t<Rng>>::iterator_category;
+} && std::derived_from<typename std::iterator_traits<r::iterator_t<Rng>>::iterator_category, std::forward_iterator_tag>;
+
+// Sorted associative containers, which can insert an element in constant time
+// when it belongs right before a hint. Their iterator pair constructors
+// don't use hints when the value type of the range differs from theirs
+// (pair<K, V> instead of pair<const K, V>), which makes sorted input O(n log n).
+template <typename Cont, typename Rng>
+concept hinted_insertable_container = requires(Cont &c, Rng &rng) {
+    typename Cont::key_compare;
+    c.emplace_hint(c.end(), *r::begin(rng));
+};
+
+// Sized ranges which are better reserved and inserted than passed to
+// the iterator pair constructor of Cont
+template <typename Cont, typename Rng, typename... Args>
+concept reserve_before_insert = r::sized_range<Rng> && !legacy_forward_range<Rng> && insertable_container<Cont> &&
+                                presizable_container<Cont> && std::constructible_from<Cont, Args...>;
+
 struct to_container {
   private:
     template <typename ToContainer, typename Rng, typename... Args>
@@ -133,6 +342,82 @@ struct to_container {
     template <typename C, typename... Args>
     struct fn {
       private:
+        // rng is sorted and unique: flat containers adopt a vector of its elements,
+        // node based containers insert each element at the end, in constant time
+        template <typename Cont, typename Rng, typename Tag, typename... Rest>
+        constexpr static auto construct_sorted(Rng &&rng, Tag &&, Rest &&...rest) {
+            if constexpr (requires {
+                              requires std::constructible_from<Cont, sorted_unique_t, typename Cont::container_type,
+                                                               Rest...>;
+                          }) {
+                return Cont(sorted_unique, to<typename Cont::container_type>(std::forward<Rng>(rng)),
+                            std::forward<Rest>(rest)...);
+            } else if constexpr (hinted_insertable_container<Cont, Rng> && std::constructible_from<Cont, Rest...>) {
+                Cont c(std::forward<Rest>(rest)...);
+                for (auto &&e : rng)
+                    c.emplace_hint(c.end(), std::forward<decltype(e)>(e));
+                return c;
+            } else {
+                static_assert(always_false_v<Cont>, "sorted_unique requires an associative container");
+            }
+        }
+
+        template <typename Cont, typename K1, typename K2>
+        constexpr static bool equivalent_keys(const Cont &c, const K1 &a, const K2 &b) {
+            if constexpr (requires { c.key_eq()(a, b); })
+                return c.key_eq()(a, b);
+            else if constexpr (requires { c.key_comp()(a, b); })
+                return !c.key_comp()(a, b) && !c.key_comp()(b, a);
+            else
+                return false;
+        }
+
+        template <typename Group, typename Value>
+        constexpr static void append(Group &g, Value &&v) {
+            if constexpr (requires { g.push_back(std::forward<Value>(v)); })
+                g.push_back(std::forward<Value>(v));
+            else
+                g.insert(g.end(), std::forward<Value>(v));
+        }
+
+        // Each element is appended to the group of its key, in a single pass.
+        // For forward ranges, consecutive elements with equivalent keys are
+        // counted first, so that their group is looked up once and grows once.
+        // (key_fn is invoked twice on the element ending a run: carrying its
+        // key over to the next run was measurably slower for shuffled keys)
+        template <typename Cont, typename Rng, typename G, typename... Rest>
+        constexpr static auto construct_grouped(Rng &&rng, G &&group, Rest &&...rest) {
+            using key_type = typename Cont::key_type;
+            using group_type = typename Cont::mapped_type;
+            Cont c(std::forward<Rest>(rest)...);
+            auto it = r::begin(rng);
+            const auto last = r::end(rng);
+            if constexpr (r::forward_range<Rng>) {
+                while (it != last) {
+                    auto first = it;
+                    key_type key(std::invoke(group.key_fn, *it));
+                    std::size_t n = 1;
+                    while (++it != last && equivalent_keys(c, key, std::invoke(group.key_fn, *it)))
+                        ++n;
+                    group_type &g = c.try_emplace(std::move(key)).first->second;
+                    if constexpr (reservable_container<group_type>) {
+                        // keep the growth geometric when a group is made of many runs
+                        if (n > 1 && g.capacity() - g.size() < n)
+                            g.reserve(std::max(g.size() + n, 2 * g.capacity()));
+                    }
+                    for (; first != it; ++first)
+                        append(g, std::invoke(group.value_fn, *first));
+                }
+            } else {
+                for (; it != last; ++it) {
+                    auto &&e = *it;
+                    group_type &g = c.try_emplace(key_type(std::invoke(group.key_fn, e))).first->second;
+                    append(g, std::invoke(group.value_fn, std::forward<decltype(e)>(e)));
+                }
+            }
+            return c;
+        }
+
         template <typename Cont, typename Rng>
         constexpr static auto construct(Rng &&rng, Args &&...args) {
             auto inserter = [](Cont &c) {
@@ -143,21 +428,44 @@ struct to_container {
                 }
             };
 
+            if constexpr (starts_with_sorted_unique<Args...>) {
+                return construct_sorted<Cont>(std::forward<Rng>(rng), std::forward<Args>(args)...);
+            } else if constexpr (starts_with_group_by<Args...>) {
+                return construct_grouped<Cont>(std::forward<Rng>(rng), std::forward<Args>(args)...);
+            } else if constexpr (joined_string_convertible<Cont, Rng> && !container_convertible<Cont, Rng>) {
+                return join_strings<Cont>(std::forward<Rng>(rng), {}, std::forward<Args>(args)...);
+            } else if constexpr (is_std_array<Cont> && sizeof...(Args) == 0) {
+                return to_std_array<Cont>(std::forward<Rng>(rng));
+            }
             // copy or move (optimization)
-            if constexpr (std::constructible_from<Cont, Rng, Args...>) {
+            else if constexpr (std::constructible_from<Cont, Rng, Args...>) {
                 return Cont(std::forward<Rng>(rng), std::forward<Args>(args)...);
             } else if constexpr (std::constructible_from<Cont, from_range_t, Rng, Args...>) {
                 return Cont(from_range, std::forward<Rng>(rng), std::forward<Args>(args)...);
             }
-            else if constexpr (r::common_range<Rng> && std::constructible_from<Cont, r::iterator_t<Rng>, r::iterator_t<Rng>, Args...>) {
+            // each element is inserted at the end, in constant time for sorted input.
+            // (a hint after the previously inserted element would cost an O(log n)
+            // increment of the rightmost node)
+            else if constexpr (hinted_insertable_container<Cont, Rng> && std::constructible_from<Cont, Args...>) {
+                Cont c(std::forward<Args>(args)...);
+                for (auto &&e : rng)
+                    c.emplace_hint(c.end(), std::forward<decltype(e)>(e));
+                return c;
+            }
+            else if constexpr (r::common_range<Rng> &&
+                               std::constructible_from<Cont, r::iterator_t<Rng>, r::iterator_t<Rng>, Args...> &&
+                               !reserve_before_insert<Cont, Rng, Args...>) {
                 return Cont(r::begin(rng), r::end(rng), std::forward<Args>(args)...);
             }
             // we can do push back
             else if constexpr (insertable_container<Cont> &&
                                std::constructible_from<Cont, Args...>) {
                 Cont c(std::forward<Args>(args)...);
-                if constexpr(r::sized_range<Rng> && reservable_container<Cont>) {
+                if constexpr(r::sized_range<Rng> && presizable_container<Cont>) {
                     c.reserve(r::size(rng));
+                } else if constexpr (size_hinted_range<Rng> && presizable_container<Cont>) {
+                    if (const std::optional<std::size_t> n = rng.size_hint())
+                        c.reserve(*n);
                 }
                 r::copy(std::forward<Rng>(rng), inserter(c));
                 return c;
@@ -167,7 +475,7 @@ struct to_container {
         }
 
         template <typename Cont, r::range Rng>
-        requires container_convertible<Cont, Rng>
+        requires container_convertible<Cont, Rng> || starts_with_group_by<Args...> || joined_string_convertible<Cont, Rng>
         constexpr static auto impl(Rng &&rng, Args &&...args) {
             return construct<Cont>(std::forward<Rng>(rng), std::forward<Args>(args)...);
         }
@@ -177,22 +485,32 @@ struct to_container {
             (!container_convertible<Cont, Rng> &&
              !std::constructible_from<Cont, Rng>)constexpr static auto impl(Rng &&rng, Args &&...args) {
 
-            return to<Cont, Args...>(rng | r::views::transform([](auto &&elem)
-            { return to<r::range_value_t<Cont>>(std::forward<decltype(elem)>(elem)); }), std::forward<Args>(args)...);
+            return to<Cont>(r::views::all(std::forward<Rng>(rng)) | r::views::transform([](auto &&elem) {
+                                return to<container_value_t<Cont>>(std::forward<decltype(elem)>(elem));
+                            }),
+                            std::forward<Args>(args)...);
         }
 
       public:
         template <typename Rng>
         requires r::input_range<Rng> &&
-            recursive_container_convertible<container_t<C, Rng, Args...>, Rng &&> inline constexpr auto
-            operator()(Rng &&rng, Args &&...args) const {
+            to_convertible<container_t<C, Rng, Args...>, Rng &&, Args...> constexpr static auto
+            convert(Rng &&rng, Args &&...args) {
             return impl<container_t<C, Rng, Args...>>(std::forward<Rng>(rng), std::forward<Args>(args)...);
         }
+
+        template <typename Rng>
+        requires r::input_range<Rng> &&
+            to_convertible<container_t<C, Rng, Args...>, Rng &&, Args...> inline constexpr auto
+            operator()(Rng &&rng, Args &&...args) const {
+            return convert(std::forward<Rng>(rng), std::forward<Args>(args)...);
+        }
+        // Args are references for lvalue arguments, so fn is not default constructible
         std::tuple<Args...> args;
     };
 
     template <typename Rng, typename ToContainer, typename... Args>
-    requires r::input_range<Rng> && recursive_container_convertible<container_t<ToContainer, Rng, Args...>, Rng>
+    requires r::input_range<Rng> && to_convertible<container_t<ToContainer, Rng, Args...>, Rng, Args...>
     constexpr friend auto operator|(Rng &&rng, fn<ToContainer, Args...> &&f) -> container_t<ToContainer, Rng, Args...> {
         return [&]<size_t... I>(std::index_sequence<I...>) {
             return f(std::forward<Rng>(rng), std::forward<Args>(std::get<I>(f.args))...);
@@ -208,28 +526,103 @@ using to_container_fn = to_container::fn<ToContainer, Args...>;
 template <template <typename...> class ContT, typename... Args, detail::to_container = {}>
 requires(!std::ranges::range<Args> && ...) constexpr auto to(Args &&...args)
     -> detail::to_container_fn<detail::wrap<ContT>, Args...> {
-    detail::to_container_fn<detail::wrap<ContT>, Args...> fn;
-    fn.args = std::forward_as_tuple(std::forward<Args>(args)...);
-    return fn;
+    return detail::to_container_fn<detail::wrap<ContT>, Args...>{std::forward_as_tuple(std::forward<Args>(args)...)};
 }
 
 template <template <typename...> class ContT, std::ranges::input_range Rng, typename... Args>
 requires std::ranges::range<Rng>
 constexpr auto to(Rng &&rng, Args &&...args) {
-    return detail::to_container_fn<detail::wrap<ContT>, Args...>{}(std::forward<Rng>(rng), std::forward<Args>(args)...);
+    return detail::to_container_fn<detail::wrap<ContT>, Args...>::convert(std::forward<Rng>(rng), std::forward<Args>(args)...);
 }
 
 template <typename Cont, typename... Args, detail::to_container = {}>
 requires(!std::ranges::range<Args> && ...) constexpr auto to(Args &&...args) -> detail::to_container_fn<Cont, Args...> {
-    detail::to_container_fn<Cont, Args...> fn;
-    fn.args = std::forward_as_tuple(std::forward<Args>(args)...);
-    return fn;
+    return detail::to_container_fn<Cont, Args...>{std::forward_as_tuple(std::forward<Args>(args)...)};
 }
 
 template <typename Cont, std::ranges::input_range Rng, typename... Args>
-requires detail::recursive_container_convertible<Cont, Rng>
+requires detail::to_convertible<Cont, Rng, Args...>
 constexpr auto to(Rng &&rng, Args &&...args) -> Cont {
-    return detail::to_container_fn<Cont, Args...>{}(std::forward<Rng>(rng), std::forward<Args>(args)...);
+    return detail::to_container_fn<Cont, Args...>::convert(std::forward<Rng>(rng), std::forward<Args>(args)...);
+}
+
+// to<std::array<range_value_t<Rng>, N>>(rng).
+// rng must have exactly N elements; usable in constant expressions.
+template <std::size_t N, std::ranges::input_range Rng>
+requires std::constructible_from<std::ranges::range_value_t<Rng>, std::ranges::range_reference_t<Rng>>
+constexpr auto to_array(Rng &&rng) -> std::array<std::ranges::range_value_t<Rng>, N> {
+    return to<std::array<std::ranges::range_value_t<Rng>, N>>(std::forward<Rng>(rng));
 }
 
+namespace detail {
+
+template <std::size_t N>
+struct to_array_fn {
+    template <std::ranges::input_range Rng>
+    constexpr friend auto operator|(Rng &&rng, to_array_fn) {
+        return rangesnext::to_array<N>(std::forward<Rng>(rng));
+    }
+};
+
+} // namespace detail
+
+template <std::size_t N>
+constexpr auto to_array() -> detail::to_array_fn<N> {
+    return {};
+}
+
+// to<std::unordered_map>(rng, group_by(key_fn, value_fn)):
+// maps each key_fn(e) to a std::vector of the value_fn(e) of the elements
+// with that key, in the order of rng
+template <typename KeyFn, typename ValueFn = std::identity>
+constexpr auto group_by(KeyFn key_fn, ValueFn value_fn = {}) -> detail::group_by_fn<KeyFn, ValueFn> {
+    return {std::move(key_fn), std::move(value_fn)};
+}
+
+namespace detail {
+
+template <typename Sep>
+concept string_separator = std::convertible_to<const Sep &, std::string_view> || std::same_as<Sep, char>;
+
+template <string_separator Sep>
+constexpr auto separator_view(const Sep &sep) -> std::string_view {
+    if constexpr (std::same_as<Sep, char>)
+        return {&sep, 1};
+    else
+        return sep;
+}
+
+template <typename Sep>
+struct join_to_string_fn;
+
+} // namespace detail
+
+// Concatenates a range of strings, string views or character arrays,
+// with sep (a string or a character) between the elements
+template <std::ranges::input_range Rng, detail::string_separator Sep = std::string_view>
+requires detail::joined_string_convertible<std::string, Rng>
+constexpr auto join_to_string(Rng &&rng, const Sep &sep = {}) -> std::string {
+    return detail::join_strings<std::string>(std::forward<Rng>(rng), detail::separator_view(sep));
+}
+
+template <detail::string_separator Sep = std::string_view>
+constexpr auto join_to_string(Sep sep = {}) -> detail::join_to_string_fn<Sep> {
+    return {std::move(sep)};
+}
+
+namespace detail {
+
+template <typename Sep>
+struct join_to_string_fn {
+    Sep sep;
+
+    template <std::ranges::input_range Rng>
+    requires joined_string_convertible<std::string, Rng>
+    constexpr friend auto operator|(Rng &&rng, join_to_string_fn &&f) -> std::string {
+        return rangesnext::join_to_string(std::forward<Rng>(rng), f.sep);
+    }
+};
+
+} // namespace detail
+
 } // namespace cor3ntin::rangesnext
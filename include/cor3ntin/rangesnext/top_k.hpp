@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+namespace cor3ntin::rangesnext {
+
+namespace r = std::ranges;
+
+namespace detail {
+
+// The k smallest elements pushed so far, according to comp, in a max-heap:
+// the largest of them is at the front, and is replaced by smaller elements
+template <typename T, typename Comp, typename Proj>
+class bounded_heap {
+    using key_t = std::invoke_result_t<Proj &, T &>;
+    using cached_key_t =
+        std::conditional_t<std::is_reference_v<key_t>, std::reference_wrapper<std::remove_reference_t<key_t>>, key_t>;
+
+    std::vector<T> heap_;
+    std::size_t k_;
+    [[no_unique_address]] Comp comp_;
+    [[no_unique_address]] Proj proj_;
+    // The projection of the front, once the heap is full: most elements are
+    // compared to it, and rejected, without projecting the front again
+    std::optional<cached_key_t> top_key_;
+
+    template <typename A, typename B>
+    bool less(A &a, B &b) {
+        return std::invoke(comp_, std::invoke(proj_, a), std::invoke(proj_, b));
+    }
+
+    decltype(auto) top_key() {
+        if constexpr (std::is_reference_v<key_t>)
+            return top_key_->get();
+        else
+            return (*top_key_);
+    }
+
+    // Replaces the front by value, whose projection key is smaller,
+    // and moves it down to its place
+    template <typename U, typename K>
+    void replace_top(U &&value, K &key) {
+        const std::size_t size = heap_.size();
+        std::size_t hole = 0;
+        std::size_t child = 1;
+        while (child < size) {
+            if (child + 1 < size && less(heap_[child], heap_[child + 1]))
+                ++child;
+            if (!std::invoke(comp_, key, std::invoke(proj_, heap_[child])))
+                break;
+            heap_[hole] = std::move(heap_[child]);
+            hole = child;
+            child = 2 * hole + 1;
+        }
+        heap_[hole] = std::forward<U>(value);
+        top_key_.emplace(std::invoke(proj_, heap_.front()));
+    }
+
+    // Once the heap is full, keeps value if it is smaller than the front.
+    // value is projected once, unless it has to be converted to T.
+    template <typename U>
+    void push_full(U &&value) {
+        auto &&key = std::invoke(proj_, value);
+        if (!std::invoke(comp_, key, top_key()))
+            return;
+        if constexpr (std::same_as<std::remove_cvref_t<U>, T>) {
+            // the key may refer to value, which is only moved from at the end
+            replace_top(std::forward<U>(value), key);
+        } else {
+            // the key may refer to the original value, which the conversion may move from
+            T converted(std::forward<U>(value));
+            auto &&converted_key = std::invoke(proj_, converted);
+            replace_top(std::move(converted), converted_key);
+        }
+    }
+
+  public:
+    bounded_heap(std::size_t k, Comp comp, Proj proj) : k_(k), comp_(std::move(comp)), proj_(std::move(proj)) {
+    }
+
+    void reserve(std::size_t n) {
+        heap_.reserve(std::min(n, k_));
+    }
+
+    std::size_t size() const {
+        return heap_.size();
+    }
+
+    // Keeps value if it is among the k smallest elements seen so far.
+    // value is only converted to T when it is kept.
+    template <typename U>
+    void push(U &&value) {
+        if (heap_.size() < k_) {
+            heap_.emplace_back(std::forward<U>(value));
+            r::push_heap(heap_, std::ref(comp_), std::ref(proj_));
+            if (heap_.size() == k_)
+                top_key_.emplace(std::invoke(proj_, heap_.front()));
+        } else if (k_ != 0) {
+            push_full(std::forward<U>(value));
+        }
+    }
+
+    // Pushes the elements of rng. Once the heap is full, the loop only
+    // compares each element to the front, and stays small enough to be inlined.
+    template <typename R>
+    void push_range(R &&rng) {
+        auto it = r::begin(rng);
+        const auto last = r::end(rng);
+        for (; it != last && heap_.size() < k_; ++it)
+            push(*it);
+        if (k_ == 0)
+            return;
+        for (; it != last; ++it)
+            push_full(*it);
+    }
+
+    void merge(bounded_heap &&other) {
+        for (auto &e : other.heap_)
+            push(std::move(e));
+        other.heap_.clear();
+    }
+
+    // The largest of the k smallest elements, if k elements were pushed
+    std::optional<T> kth() && {
+        if (k_ == 0 || heap_.size() < k_)
+            return std::nullopt;
+        return std::move(heap_.front());
+    }
+
+    // The k smallest elements, sorted
+    std::vector<T> sorted() && {
+        r::sort_heap(heap_, std::ref(comp_), std::ref(proj_));
+        return std::move(heap_);
+    }
+};
+
+template <typename R, typename Comp, typename Proj>
+using bounded_heap_for = bounded_heap<r::range_value_t<R>, Comp, Proj>;
+
+template <typename R, typename Comp, typename Proj>
+auto make_bounded_heap(R &rng, std::size_t k, Comp comp, Proj proj) {
+    bounded_heap_for<R, Comp, Proj> heap(k, std::move(comp), std::move(proj));
+    if constexpr (r::sized_range<R>)
+        heap.reserve(static_cast<std::size_t>(r::size(rng)));
+    return heap;
+}
+
+template <typename R, typename Comp, typename Proj>
+concept top_k_range = r::input_range<R> &&
+                      std::indirect_strict_weak_order<Comp, std::projected<r::iterator_t<R>, Proj>> &&
+                      std::constructible_from<r::range_value_t<R>, r::range_reference_t<R>> &&
+                      std::movable<r::range_value_t<R>>;
+
+struct top_k_fn {
+    // The k smallest elements of rng according to comp, sorted, as by
+    // partial_sort, but holding at most k elements at once.
+    // The order of equivalent elements is unspecified.
+    template <r::input_range R, typename Comp = r::less, typename Proj = std::identity>
+    requires top_k_range<R, Comp, Proj>
+    auto operator()(R &&rng, std::size_t k, Comp comp = {}, Proj proj = {}) const
+        -> std::vector<r::range_value_t<R>> {
+        auto heap = make_bounded_heap(rng, k, std::move(comp), std::move(proj));
+        heap.push_range(rng);
+        return std::move(heap).sorted();
+    }
+};
+
+struct nth_smallest_fn {
+    // The element which would be at index n if rng was sorted according to comp,
+    // or nullopt if rng has n elements or less. Holds at most n + 1 elements at once.
+    template <r::input_range R, typename Comp = r::less, typename Proj = std::identity>
+    requires top_k_range<R, Comp, Proj>
+    auto operator()(R &&rng, std::size_t n, Comp comp = {}, Proj proj = {}) const
+        -> std::optional<r::range_value_t<R>> {
+        auto heap = make_bounded_heap(rng, n + 1, std::move(comp), std::move(proj));
+        heap.push_range(rng);
+        return std::move(heap).kth();
+    }
+};
+
+} // namespace detail
+
+inline constexpr detail::top_k_fn top_k;
+inline constexpr detail::nth_smallest_fn nth_smallest;
+
+} // namespace cor3ntin::rangesnext
@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/async_generator.hpp>
+#include <cor3ntin/rangesnext/event_loop.hpp>
+
+#include <coroutine>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+
+using namespace cor3ntin::rangesnext;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct socket_pair {
+    int fds[2];
+    socket_pair() {
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+    }
+    ~socket_pair() {
+        close_writer();
+        ::close(fds[0]);
+    }
+    void close_writer() {
+        if (fds[1] >= 0)
+            ::close(std::exchange(fds[1], -1));
+    }
+};
+
+async_generator<std::string> lines(event_loop &loop, int fd) {
+    std::string pending;
+    std::byte buffer[16];
+    for (;;) {
+        const auto n = co_await loop.read_some(fd, buffer);
+        if (n == 0)
+            break;
+        pending.append(reinterpret_cast<const char *>(buffer), n);
+        std::size_t pos;
+        while ((pos = pending.find('\n')) != std::string::npos) {
+            co_yield pending.substr(0, pos);
+            pending.erase(0, pos + 1);
+        }
+    }
+    if (!pending.empty())
+        co_yield pending;
+}
+
+task<void> send(event_loop &loop, socket_pair &s, std::vector<std::string_view> chunks) {
+    for (auto chunk : chunks) {
+        co_await loop.write_all(s.fds[1], std::as_bytes(std::span(chunk)));
+        co_await loop.sleep_for(1ms);
+    }
+    s.close_writer();
+}
+
+// Fills the socket buffer, so that fd is no longer writable
+void fill(int fd) {
+    const char chunk[4096] = {};
+    while (::write(fd, chunk, sizeof(chunk)) > 0) {
+    }
+}
+
+// Drains the socket buffer, so that its peer is writable again
+void drain(int fd) {
+    char chunk[4096];
+    while (::read(fd, chunk, sizeof(chunk)) > 0) {
+    }
+}
+
+// A coroutine started eagerly and destroyed explicitly,
+// to destroy a coroutine suspended in the loop
+struct detached {
+    struct promise_type {
+        detached get_return_object() {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() {
+            throw;
+        }
+    };
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+template <typename Gen>
+task<std::vector<std::string>> collect(Gen gen) {
+    std::vector<std::string> res;
+    auto it = co_await gen.begin();
+    while (it != gen.end()) {
+        res.push_back(*it);
+        co_await ++it;
+    }
+    co_return res;
+}
+
+} // namespace
+
+TEST_CASE("Async generator over a socket", "[AsyncGenerator]") {
+    event_loop loop;
+    socket_pair s;
+
+    loop.spawn(send(loop, s, {"Hello\nWor", "ld\n", "a very long line, longer than the buffer\n", "last"}));
+    auto res = loop.run(collect(lines(loop, s.fds[0])));
+
+    CHECK_THAT(res, Catch::Equals(std::vector<std::string>{
+                        "Hello", "World", "a very long line, longer than the buffer", "last"}));
+}
+
+TEST_CASE("for_each over an async generator", "[AsyncGenerator]") {
+    event_loop loop;
+    auto ticks = [](event_loop &loop, int n) -> async_generator<int> {
+        for (int i = 0; i < n; ++i) {
+            co_await loop.sleep_for(1ms);
+            co_yield i;
+        }
+    };
+
+    std::vector<int> seen;
+    loop.run(for_each(ticks(loop, 5), [&](int i) { seen.push_back(i); }));
+    CHECK_THAT(seen, Catch::Equals(std::vector{0, 1, 2, 3, 4}));
+}
+
+TEST_CASE("Timers and interleaving", "[AsyncGenerator]") {
+    event_loop loop;
+    std::vector<int> order;
+    auto after = [](event_loop &loop, std::vector<int> &order, int ms) -> task<void> {
+        co_await loop.sleep_for(std::chrono::milliseconds(ms));
+        order.push_back(ms);
+    };
+    loop.spawn(after(loop, order, 20));
+    loop.spawn(after(loop, order, 5));
+    loop.spawn(after(loop, order, 10));
+    loop.run();
+    CHECK_THAT(order, Catch::Equals(std::vector{5, 10, 20}));
+}
+
+TEST_CASE("Exceptions in async generators", "[AsyncGenerator]") {
+    event_loop loop;
+    auto failing = [](event_loop &loop) -> async_generator<std::string> {
+        co_yield std::string("first");
+        co_await loop.schedule();
+        throw std::runtime_error("failed");
+    };
+    CHECK_THROWS_AS(loop.run(collect(failing(loop))), std::runtime_error);
+}
+
+TEST_CASE("A reader and a writer waiting on the same socket", "[AsyncGenerator]") {
+    event_loop loop;
+    socket_pair s;
+    fill(s.fds[0]);
+    std::vector<std::string> order;
+    auto reader = [&]() -> task<void> {
+        co_await loop.readable(s.fds[0]);
+        order.push_back("reader");
+    };
+    auto writer = [&]() -> task<void> {
+        co_await loop.writable(s.fds[0]);
+        order.push_back("writer");
+    };
+    loop.spawn(reader());
+    loop.spawn(writer());
+    auto peer = [&]() -> task<void> {
+        co_await loop.sleep_for(1ms);
+        drain(s.fds[1]);
+        co_await loop.sleep_for(1ms);
+        ::write(s.fds[1], "x", 1);
+    };
+    loop.spawn(peer());
+    loop.run();
+    CHECK_THAT(order, Catch::Equals(std::vector<std::string>{"writer", "reader"}));
+}
+
+TEST_CASE("A coroutine destroyed while waiting on a socket", "[AsyncGenerator]") {
+    event_loop loop;
+    socket_pair s;
+    bool resumed = false;
+    auto waiting = [](event_loop &loop, int fd, bool &resumed) -> detached {
+        co_await loop.readable(fd);
+        resumed = true;
+    };
+    auto d = waiting(loop, s.fds[0], resumed);
+    d.coroutine.destroy();
+    ::write(s.fds[1], "x", 1);
+    // nothing is waiting anymore
+    CHECK(!loop.run_once());
+
+    // the socket can be awaited again
+    d = waiting(loop, s.fds[0], resumed);
+    loop.run();
+    CHECK(resumed);
+    d.coroutine.destroy();
+}
+
+TEST_CASE("A coroutine destroyed while sleeping", "[AsyncGenerator]") {
+    event_loop loop;
+    bool resumed = false;
+    auto sleeping = [](event_loop &loop, bool &resumed) -> detached {
+        co_await loop.sleep_for(1ms);
+        resumed = true;
+    };
+    auto scheduled = [](event_loop &loop, bool &resumed) -> detached {
+        co_await loop.schedule();
+        resumed = true;
+    };
+    auto a = sleeping(loop, resumed);
+    auto b = scheduled(loop, resumed);
+    auto c = sleeping(loop, resumed);
+    a.coroutine.destroy();
+    b.coroutine.destroy();
+    loop.run();
+    CHECK(resumed);
+    c.coroutine.destroy();
+
+    // destroyed once its timer expired, before being resumed
+    resumed = false;
+    auto destroy = [](event_loop &loop, detached &d) -> detached {
+        co_await loop.schedule();
+        d.coroutine.destroy();
+    };
+    detached d;
+    auto e = destroy(loop, d);
+    d = scheduled(loop, resumed);
+    loop.run();
+    CHECK(!resumed);
+    e.coroutine.destroy();
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/batch_generator.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(std::ranges::input_range<batch_generator<int>>);
+static_assert(!std::ranges::forward_range<batch_generator<int>>);
+static_assert(std::same_as<r::range_reference_t<batch_generator<int>>, const int &>);
+
+template <std::size_t N>
+batch_generator<int, N> iota(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+TEST_CASE("Batch generator", "[BatchGenerator]") {
+    for (int n : {0, 1, 3, 4, 5, 100}) {
+        auto expected = r::views::iota(0, n) | to<std::vector>();
+        CHECK_THAT(iota<4>(n) | to<std::vector>(), Catch::Equals(expected));
+    }
+
+    SECTION("suspends once per batch") {
+        auto f = [](int n, int &suspensions) -> batch_generator<int, 8> {
+            for (int i = 0; i < n; ++i) {
+                co_yield i;
+                if (i % 8 == 7)
+                    ++suspensions;
+            }
+        };
+        int suspensions = 0;
+        auto g = f(20, suspensions);
+        auto it = g.begin();
+        CHECK(suspensions == 0);
+        for (int i = 0; i < 8; ++i, ++it)
+            CHECK(*it == i);
+        CHECK(suspensions == 1);
+    }
+
+    SECTION("enumerate") {
+        for (auto &&[i, v] : iota<3>(10) | enumerate) {
+            CHECK(static_cast<int>(i) == v);
+        }
+    }
+}
+
+TEST_CASE("Batch generator yielding spans", "[BatchGenerator]") {
+    auto f = []() -> batch_generator<int, 4> {
+        std::vector<int> v(10);
+        std::iota(v.begin(), v.end(), 0);
+        co_yield 100;
+        co_yield std::span<const int>(v.data(), 2);
+        co_yield std::span<const int>(v);
+        co_yield std::span<const int>();
+        co_yield 101;
+        co_yield std::span<const int>(v.data(), 1);
+        co_yield std::span<const int>(v.data() + 5, 5);
+    };
+    std::vector expected{100, 0, 1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 101, 0, 5, 6, 7, 8, 9};
+    CHECK_THAT(f() | to<std::vector>(), Catch::Equals(expected));
+}
+
+TEST_CASE("Exceptions in batch generators", "[BatchGenerator]") {
+    auto f = [](int n) -> batch_generator<int, 4> {
+        for (int i = 0; i < n; ++i)
+            co_yield i;
+        throw std::runtime_error("failed");
+    };
+    // n = 6 throws with a partial batch, n = 4 with an empty one
+    for (int n : {0, 4, 6}) {
+        std::vector<int> seen;
+        CHECK_THROWS_AS(
+            [&] {
+                for (int i : f(n))
+                    seen.push_back(i);
+            }(),
+            std::runtime_error);
+        CHECK_THAT(seen, Catch::Equals(r::views::iota(0, n) | to<std::vector>()));
+    }
+}
@@ -0,0 +1,226 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/channel.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::input_range<channel<int>::consumer_view>);
+static_assert(r::view<channel<int>::consumer_view>);
+
+namespace {
+
+// Pushes [first, last) from each producer, then closes the channel
+// once all the producers are done
+// (Catch assertions are not thread safe, failures are counted instead)
+template <typename Push>
+std::vector<std::jthread> produce(channel<int> &ch, int producers, int per_producer, Push push,
+                                  std::atomic<int> &failures) {
+    auto remaining = std::make_shared<std::atomic<int>>(producers);
+    std::vector<std::jthread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ch, &failures, p, per_producer, push, remaining] {
+            if (!push(ch, p * per_producer, (p + 1) * per_producer))
+                ++failures;
+            if (remaining->fetch_sub(1) == 1)
+                ch.close();
+        });
+    }
+    return threads;
+}
+
+bool push_each(channel<int> &ch, int first, int last) {
+    for (int i = first; i < last; ++i) {
+        if (!ch.push(i))
+            return false;
+    }
+    return true;
+}
+
+bool push_batches(channel<int> &ch, int first, int last) {
+    std::vector<int> batch;
+    for (int i = first; i < last; i += 100) {
+        batch.clear();
+        for (int j = i; j < std::min(i + 100, last); ++j)
+            batch.push_back(j);
+        if (ch.push_range(batch) != batch.size())
+            return false;
+    }
+    return true;
+}
+
+generator<int> doubled(channel<int> &ch) {
+    for (int i : ch.consume())
+        co_yield i * 2;
+}
+
+} // namespace
+
+TEST_CASE("channel", "[Channel]") {
+    channel<std::unique_ptr<int>> ch(3);
+    CHECK(ch.capacity() == 4);
+    CHECK(!ch.try_pop());
+
+    for (int i = 0; i < 4; ++i) {
+        auto p = std::make_unique<int>(i);
+        CHECK(ch.try_push(std::move(p)));
+        CHECK(!p);
+    }
+    auto p = std::make_unique<int>(4);
+    CHECK(!ch.try_push(std::move(p)));
+    CHECK(p);
+
+    CHECK(**ch.pop() == 0);
+    CHECK(ch.try_push(std::move(p)));
+    ch.close();
+    CHECK(ch.closed());
+    CHECK(!ch.push(std::make_unique<int>(5)));
+
+    std::vector<int> res;
+    for (auto &e : ch.consume())
+        res.push_back(*e);
+    CHECK(res == std::vector{1, 2, 3, 4});
+    CHECK(!ch.pop());
+}
+
+TEST_CASE("channel try_push", "[Channel]") {
+    channel<std::string> ch(2);
+    const std::string first = "first";
+    CHECK(ch.try_push(first));
+    CHECK(first == "first");
+    CHECK(ch.try_push(std::string(100, 'x')));
+    std::string third = "third";
+    CHECK(!ch.try_push(std::move(third)));
+    CHECK(third == "third");
+    CHECK(!ch.try_push(third));
+    CHECK(*ch.pop() == "first");
+    CHECK(ch.pop()->size() == 100);
+}
+
+TEST_CASE("channel batches", "[Channel]") {
+    channel<int> ch(8);
+    std::vector<int> in = {1, 2, 3, 4, 5};
+    CHECK(ch.push_range(in) == 5);
+
+    std::vector<int> out;
+    CHECK(ch.pop_some(std::back_inserter(out), 3) == 3);
+    CHECK(ch.pop_some(std::back_inserter(out), 10) == 2);
+    CHECK(out == in);
+    CHECK(ch.pop_some(std::back_inserter(out), 0) == 0);
+
+    ch.close();
+    CHECK(ch.pop_some(std::back_inserter(out), 10) == 0);
+    CHECK(ch.push_range(in) == 0);
+}
+
+TEST_CASE("channel blocking", "[Channel]") {
+    SECTION("close wakes up the consumers") {
+        channel<int> ch;
+        std::optional<int> res = 0;
+        {
+            std::jthread consumer([&] { res = ch.pop(); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            ch.close();
+        }
+        CHECK(!res);
+    }
+    SECTION("close wakes up the producers") {
+        channel<int> ch(2);
+        CHECK(ch.push(1));
+        CHECK(ch.push(2));
+        bool res = true;
+        {
+            std::jthread producer([&] { res = ch.push(3); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            ch.close();
+        }
+        CHECK(!res);
+    }
+    SECTION("a full channel blocks the producer until an element is popped") {
+        channel<int> ch(2);
+        std::jthread producer([&] {
+            for (int i = 0; i < 1000; ++i)
+                ch.push(i);
+            ch.close();
+        });
+        CHECK((ch.consume() | to<std::vector>()) == (r::iota_view(0, 1000) | to<std::vector>()));
+    }
+}
+
+TEST_CASE("channel consumer range", "[Channel]") {
+    channel<int> ch(4);
+    std::jthread producer([&] {
+        for (int i = 0; i < 10; ++i)
+            ch.push(i);
+        ch.close();
+    });
+
+    SECTION("enumerate") {
+        for (auto [i, e] : enumerate(ch.consume()))
+            CHECK(int(i) == e);
+    }
+    SECTION("generator") {
+        CHECK((doubled(ch) | to<std::vector>()) == std::vector{0, 2, 4, 6, 8, 10, 12, 14, 16, 18});
+    }
+}
+
+TEST_CASE("channel stress", "[Channel]") {
+    constexpr int per_producer = 20000;
+    for (int producers : {1, 2, 4, 8}) {
+        for (int consumers : {1, 3}) {
+            for (auto push : {&push_each, &push_batches}) {
+                CAPTURE(producers, consumers);
+                channel<int> ch(64);
+                std::vector<std::vector<int>> received(consumers);
+                std::atomic<int> failures = 0;
+                {
+                    auto threads = produce(ch, producers, per_producer, push, failures);
+                    std::vector<std::jthread> readers;
+                    for (int c = 0; c < consumers; ++c) {
+                        readers.emplace_back([&ch, &out = received[c], batch = c % 2 == 1] {
+                            if (batch) {
+                                while (ch.pop_some(std::back_inserter(out), 32)) {
+                                }
+                            } else {
+                                for (int i : ch.consume())
+                                    out.push_back(i);
+                            }
+                        });
+                    }
+                }
+                REQUIRE(failures == 0);
+                // elements of a producer are received in order by each consumer
+                for (auto &out : received) {
+                    std::vector<int> last(producers, -1);
+                    for (int i : out) {
+                        REQUIRE(i > last[i / per_producer]);
+                        last[i / per_producer] = i;
+                    }
+                }
+                std::vector<int> all;
+                for (auto &out : received)
+                    all.insert(all.end(), out.begin(), out.end());
+                r::sort(all);
+                REQUIRE(all.size() == std::size_t(producers * per_producer));
+                for (std::size_t i = 0; i < all.size(); ++i)
+                    REQUIRE(all[i] == int(i));
+            }
+        }
+    }
+}
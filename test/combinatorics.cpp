@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/combinatorics.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+template <typename Rng>
+void check_random_access(Rng &&v) {
+    auto expected = v | to<std::vector>();
+    REQUIRE(v.size() == expected.size());
+    auto first = r::begin(v);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        CHECK(first[static_cast<std::ptrdiff_t>(i)] == expected[i]);
+        CHECK((first + static_cast<std::ptrdiff_t>(i)) - first == static_cast<std::ptrdiff_t>(i));
+    }
+    CHECK_THAT(v | r::views::reverse | to<std::vector>(),
+               Catch::Equals(r::reverse_view(expected) | to<std::vector>()));
+}
+
+TEST_CASE("Combinations", "[Combinatorics]") {
+    std::vector v{1, 2, 3, 4};
+    auto c = combinations<2>(v);
+
+    using R = decltype(c);
+    static_assert(r::random_access_range<R>);
+    static_assert(r::sized_range<R>);
+    static_assert(std::same_as<r::range_reference_t<R>, std::tuple<int &, int &>>);
+    static_assert(std::same_as<r::range_value_t<R>, std::tuple<int, int>>);
+
+    std::vector<std::tuple<int, int>> expected = {{1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}};
+    CHECK_THAT((c | to<std::vector<std::tuple<int, int>>>()), Catch::Equals(expected));
+    check_random_access(c);
+    check_random_access(v | combinations<3>);
+
+    CHECK((v | combinations<0>).size() == 1);
+    CHECK((v | combinations<5>).size() == 0);
+    CHECK(r::empty(v | combinations<5>));
+}
+
+TEST_CASE("Combinations near the limit of the difference type", "[Combinatorics]") {
+    static_assert(sizeof(std::ptrdiff_t) == 8);
+    std::vector<int> v = r::views::iota(0, 66) | to<std::vector>();
+
+    // C(64, 32) and C(66, 33) fit in 63 bits, their intermediate products don't
+    CHECK(combinations<32>(r::views::take(v, 64)).size() == 1832624140942590534u);
+    auto c = combinations<33>(v);
+    CHECK(c.size() == 7219428434016265740u);
+    CHECK(std::get<0>(c[std::ptrdiff_t(c.size()) - 1]) == 33);
+    CHECK(std::get<32>(c[std::ptrdiff_t(c.size()) - 1]) == 65);
+
+    // C(67, 33) doesn't
+    v.push_back(66);
+    CHECK_THROWS_AS(combinations<33>(v).size(), std::overflow_error);
+}
+
+TEST_CASE("Combinations with replacement", "[Combinatorics]") {
+    std::vector v{'a', 'b', 'c'};
+    auto c = combinations_with_replacement<2>(v);
+
+    std::vector<std::tuple<char, char>> expected = {{'a', 'a'}, {'a', 'b'}, {'a', 'c'},
+                                                    {'b', 'b'}, {'b', 'c'}, {'c', 'c'}};
+    CHECK_THAT((c | to<std::vector<std::tuple<char, char>>>()), Catch::Equals(expected));
+    check_random_access(c);
+    check_random_access(v | combinations_with_replacement<4>);
+}
+
+TEST_CASE("Permutations", "[Combinatorics]") {
+    std::vector v{1, 2, 3};
+
+    std::vector<std::tuple<int, int>> expected = {{1, 2}, {1, 3}, {2, 1}, {2, 3}, {3, 1}, {3, 2}};
+    CHECK_THAT((permutations<2>(v) | to<std::vector<std::tuple<int, int>>>()), Catch::Equals(expected));
+
+    std::vector<int> big{0, 1, 2, 3, 4};
+    auto all = big | permutations<5>;
+    CHECK(all.size() == 120);
+    CHECK(r::is_sorted(all | to<std::vector>()));
+    check_random_access(all);
+    check_random_access(big | permutations<3>);
+}
+
+TEST_CASE("Product repeat", "[Combinatorics]") {
+    std::vector v{0, 1};
+    auto p = product_repeat<3>(v);
+
+    using R = decltype(p);
+    static_assert(r::random_access_range<R>);
+    static_assert(std::same_as<r::range_reference_t<R>, std::tuple<int &, int &, int &>>);
+
+    CHECK(p.size() == 8);
+    using T = std::vector<std::tuple<int, int, int>>;
+    CHECK_THAT(p | to<T>(), Catch::Equals(product(v, v, v) | to<T>()));
+}
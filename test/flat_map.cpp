@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/flat_map.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::random_access_range<flat_set<int>>);
+static_assert(r::random_access_range<flat_map<int, int>>);
+static_assert(std::same_as<flat_set<int>::iterator, flat_set<int>::const_iterator>);
+static_assert(detail::insertable_container<flat_set<int>>);
+static_assert(detail::reservable_container<flat_map<int, int>>);
+
+namespace {
+
+generator<std::pair<int, std::string>> entries() {
+    co_yield {3, "c"};
+    co_yield {1, "a"};
+    co_yield {2, "b"};
+    co_yield {1, "z"};
+}
+
+} // namespace
+
+TEST_CASE("flat_set", "[flat_map]") {
+    flat_set<int> s = {5, 1, 3, 1, 4};
+    CHECK(s.size() == 4);
+    CHECK(r::equal(s, std::vector{1, 3, 4, 5}));
+    CHECK(s.contains(3));
+    CHECK(!s.contains(2));
+    CHECK(s.count(4) == 1);
+    CHECK(*s.lower_bound(2) == 3);
+    CHECK(*s.upper_bound(3) == 4);
+
+    SECTION("insert") {
+        CHECK(s.insert(2).second);
+        CHECK(!s.insert(2).second);
+        CHECK(*s.insert(s.end(), 6) == 6);
+        // wrong hints are ignored
+        CHECK(*s.insert(s.begin(), 0) == 0);
+        CHECK(*s.insert(s.end(), -1) == -1);
+        CHECK(r::equal(s, std::vector{-1, 0, 1, 2, 3, 4, 5, 6}));
+    }
+
+    SECTION("insert ranges") {
+        std::vector v = {9, 2, 7, 2, 3};
+        s.insert(v.begin(), v.end());
+        CHECK(r::equal(s, std::vector{1, 2, 3, 4, 5, 7, 9}));
+        s.insert_range(std::vector{10, 11});
+        CHECK(s.size() == 9);
+        s.insert(sorted_unique, v.begin() + 2, v.begin() + 3);
+        CHECK(s.size() == 9);
+    }
+
+    SECTION("erase") {
+        CHECK(s.erase(3) == 1);
+        CHECK(s.erase(3) == 0);
+        s.erase(s.begin());
+        CHECK(r::equal(s, std::vector{4, 5}));
+    }
+
+    SECTION("comparator and underlying container") {
+        flat_set<int, std::greater<int>> g = {1, 3, 2};
+        CHECK(r::equal(g, std::vector{3, 2, 1}));
+        auto v = std::move(g).extract();
+        CHECK(v == std::vector{3, 2, 1});
+        CHECK(g.empty());
+        g.replace(std::move(v));
+        CHECK(g.size() == 3);
+        flat_set<int, std::greater<int>> h(sorted_unique, {4, 2});
+        CHECK(g < h);
+    }
+}
+
+TEST_CASE("flat_map", "[flat_map]") {
+    flat_map<std::string, int> m;
+    m["b"] = 2;
+    m["a"] = 1;
+    m.emplace("c", 3);
+    CHECK(m.size() == 3);
+    CHECK(m.begin()->first == "a");
+    CHECK(m.at("c") == 3);
+    CHECK_THROWS_AS(m.at("d"), std::out_of_range);
+    CHECK(!m.try_emplace("a", 10).second);
+    CHECK(m["a"] == 1);
+    CHECK(!m.insert_or_assign("a", 10).second);
+    CHECK(m["a"] == 10);
+    CHECK(m.find("b")->second == 2);
+    CHECK(m.find("z") == m.end());
+    auto [first, last] = m.equal_range("b");
+    CHECK(std::distance(first, last) == 1);
+    CHECK(m.value_comp()(*m.begin(), *std::next(m.begin())));
+}
+
+TEST_CASE("to flat containers", "[flat_map]") {
+    std::vector<std::pair<int, std::string>> v = {{2, "b"}, {1, "a"}, {2, "x"}, {3, "c"}};
+
+    SECTION("deduced") {
+        auto m = v | to<flat_map>();
+        STATIC_REQUIRE(std::same_as<decltype(m), flat_map<int, std::string>>);
+        // like std::map, the first of equivalent elements is kept
+        CHECK(m == (v | to<std::map>() | to<flat_map<int, std::string>>()));
+        CHECK(m.at(2) == "b");
+
+        auto g = to<flat_map>(v, std::greater<int>{});
+        STATIC_REQUIRE(std::same_as<decltype(g), flat_map<int, std::string, std::greater<int>>>);
+        CHECK(g.begin()->first == 3);
+
+        auto s = std::vector{3, 1, 2, 1} | to<flat_set>();
+        CHECK(r::equal(s, std::vector{1, 2, 3}));
+    }
+
+    SECTION("input ranges") {
+        auto m = entries() | to<flat_map<int, std::string>>();
+        CHECK(m.size() == 3);
+        CHECK(m.at(1) == "a");
+    }
+
+    SECTION("sorted_unique") {
+        std::vector<std::pair<int, int>> sorted = {{1, 1}, {2, 4}, {3, 9}};
+        auto m = sorted | to<flat_map>(sorted_unique);
+        STATIC_REQUIRE(std::same_as<decltype(m), flat_map<int, int>>);
+        CHECK(m.size() == 3);
+
+        auto std_map = to<std::map>(sorted, sorted_unique);
+        STATIC_REQUIRE(std::same_as<decltype(std_map), std::map<int, int>>);
+        CHECK(std_map == std::map<int, int>{{1, 1}, {2, 4}, {3, 9}});
+
+        auto set = std::views::iota(0, 100) | to<std::set<int>>(sorted_unique);
+        CHECK(set.size() == 100);
+
+        auto greater = std::views::iota(0, 10) | std::views::reverse | to<flat_set>(sorted_unique, std::greater<int>{});
+        STATIC_REQUIRE(std::same_as<decltype(greater), flat_set<int, std::greater<int>>>);
+        CHECK(*greater.begin() == 9);
+    }
+
+    SECTION("nested") {
+        std::vector<std::vector<int>> nested = {{3, 1}, {2, 2}};
+        auto res = nested | to<std::vector<flat_set<int>>>();
+        CHECK(r::equal(res[0], std::vector{1, 3}));
+        CHECK(res[1].size() == 1);
+    }
+}
@@ -5,16 +5,24 @@ Licenced under Boost Software License license. See LICENSE.md for details.
 */
 
 #include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/frame_pool.hpp>
 #include <cor3ntin/rangesnext/generator.hpp>
 #include <cor3ntin/rangesnext/to.hpp>
 
+#include <memory_resource>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace cor3ntin::rangesnext;
 namespace r = std::ranges;
 
 static_assert(std::ranges::input_range<generator<int>>);
 static_assert(!std::ranges::forward_range<generator<int>>);
+static_assert(std::same_as<r::range_reference_t<generator<std::string &&>>, std::string &&>);
+static_assert(std::same_as<r::range_reference_t<generator<std::string>>, std::string &>);
 
 TEST_CASE("Basic Generator Tests", "[Generator]") {
 
@@ -78,3 +86,349 @@ TEST_CASE("Zip Generator", "[Generator]") {
 
     CHECK_THAT(z | to<std::vector>(), Catch::Equals(expected));
 }
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    std::size_t *allocated;
+
+    counting_allocator(std::size_t *allocated) : allocated(allocated) {
+    }
+    template <typename U>
+    counting_allocator(const counting_allocator<U> &other)
+        : allocated(other.allocated) {
+    }
+
+    T *allocate(std::size_t n) {
+        *allocated += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, std::size_t n) {
+        *allocated -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+    template <typename U>
+    bool operator==(const counting_allocator<U> &other) const {
+        return allocated == other.allocated;
+    }
+};
+
+template <typename Alloc>
+generator<int> iota_with(std::allocator_arg_t, Alloc, int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+struct numbers {
+    int n;
+
+    template <typename Alloc>
+    generator<int> iota(std::allocator_arg_t, Alloc) const {
+        for (int i = 0; i < n; ++i)
+            co_yield i;
+    }
+};
+
+TEST_CASE("Generator frame allocators", "[Generator]") {
+    SECTION("allocator_arg") {
+        std::size_t allocated = 0;
+        {
+            auto g = iota_with(std::allocator_arg,
+                               counting_allocator<char>(&allocated), 3);
+            CHECK(allocated > 0);
+            CHECK_THAT(g | to<std::vector>(),
+                       Catch::Equals(std::vector{0, 1, 2}));
+        }
+        CHECK(allocated == 0);
+    }
+
+    SECTION("allocator_arg in a member function") {
+        std::size_t allocated = 0;
+        {
+            const numbers two{2};
+            auto g = two.iota(std::allocator_arg, counting_allocator<char>(&allocated));
+            CHECK(allocated > 0);
+            CHECK_THAT(g | to<std::vector>(), Catch::Equals(std::vector{0, 1}));
+        }
+        CHECK(allocated == 0);
+    }
+
+    SECTION("only coroutines taking an allocator store how to deallocate their frame") {
+        using G = generator<int>;
+        using erased = G::allocator_arg_promise_type;
+        STATIC_REQUIRE(std::same_as<std::coroutine_traits<G, int>::promise_type, G::promise_type>);
+        using alloc = std::allocator<int>;
+        STATIC_REQUIRE(std::same_as<std::coroutine_traits<G, std::allocator_arg_t, alloc, int>::promise_type, erased>);
+        // member functions
+        STATIC_REQUIRE(
+            std::same_as<std::coroutine_traits<G, const int &, std::allocator_arg_t, alloc>::promise_type, erased>);
+    }
+
+    SECTION("pmr") {
+        std::byte buffer[4096];
+        std::pmr::monotonic_buffer_resource arena(
+            buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        auto f = [](std::allocator_arg_t, std::pmr::polymorphic_allocator<>,
+                    int n) -> pmr::generator<int> {
+            for (int i = 0; i < n; ++i)
+                co_yield i;
+        };
+        auto g = f(std::allocator_arg, &arena, 3);
+        CHECK_THAT(g | to<std::vector>(), Catch::Equals(std::vector{0, 1, 2}));
+
+        // without allocator_arg, the default resource is used
+        auto g2 = [](int n) -> pmr::generator<int> { co_yield n; }(42);
+        CHECK_THAT(g2 | to<std::vector>(), Catch::Equals(std::vector{42}));
+    }
+
+    SECTION("recycling pool") {
+        auto f = [](int n) -> generator<int, int, recycling_frame_allocator<>> {
+            for (int i = 0; i < n; ++i)
+                co_yield i;
+        };
+        frame_pool::release();
+        frame_pool::reset_stats();
+        for (int i = 0; i < 100; ++i) {
+            CHECK(r::distance(f(i)) == i);
+        }
+        auto stats = frame_pool::stats();
+        CHECK(stats.misses == 1);
+        CHECK(stats.hits == 99);
+        CHECK(stats.deallocations == 100);
+        CHECK(stats.hit_rate() == Approx(0.99));
+        frame_pool::release();
+    }
+}
+
+struct tree {
+    int value;
+    std::vector<tree> children;
+};
+
+generator<const int &> walk(const tree &t) {
+    co_yield t.value;
+    for (const auto &child : t.children) {
+        co_yield elements_of(walk(child));
+    }
+}
+
+generator<int> countdown(int n) {
+    if (n < 0)
+        co_return;
+    co_yield n;
+    co_yield elements_of(countdown(n - 1));
+}
+
+TEST_CASE("Recursive generators", "[Generator]") {
+    SECTION("tree") {
+        tree t{1, {{2, {{3, {}}, {4, {}}}}, {5, {}}, {6, {{7, {{8, {}}}}}}}};
+        CHECK_THAT(walk(t) | to<std::vector<int>>(),
+                   Catch::Equals(std::vector{1, 2, 3, 4, 5, 6, 7, 8}));
+    }
+
+    SECTION("deep") {
+        auto v = countdown(10000) | to<std::vector<int>>();
+        REQUIRE(v.size() == 10001);
+        CHECK(v.front() == 10000);
+        CHECK(v.back() == 0);
+    }
+
+    SECTION("empty nested generators") {
+        auto f = []() -> generator<int> {
+            co_yield elements_of(countdown(-1));
+            co_yield 1;
+            co_yield elements_of(countdown(-1));
+        };
+        CHECK_THAT(f() | to<std::vector>(), Catch::Equals(std::vector{1}));
+    }
+
+    SECTION("ranges") {
+        auto f = []() -> generator<const int &> {
+            std::vector v{1, 2};
+            co_yield elements_of(v);
+            co_yield elements_of(r::views::iota(3, 5));
+        };
+        CHECK_THAT(f() | to<std::vector<int>>(),
+                   Catch::Equals(std::vector{1, 2, 3, 4}));
+    }
+
+    SECTION("partially consumed") {
+        auto g = countdown(100);
+        auto it = g.begin();
+        for (int i = 0; i < 50; ++i)
+            ++it;
+        CHECK(*it == 50);
+    }
+}
+
+TEST_CASE("Exceptions in recursive generators", "[Generator]") {
+    auto thrower = []() -> generator<int> {
+        co_yield 1;
+        throw std::runtime_error("nested");
+    };
+
+    SECTION("propagated to the consumer") {
+        auto f = [&]() -> generator<int> {
+            co_yield 0;
+            co_yield elements_of(thrower());
+            co_yield 2;
+        };
+        std::vector<int> seen;
+        CHECK_THROWS_AS(
+            [&] {
+                for (int i : f())
+                    seen.push_back(i);
+            }(),
+            std::runtime_error);
+        CHECK_THAT(seen, Catch::Equals(std::vector{0, 1}));
+    }
+
+    SECTION("caught by the parent") {
+        auto f = [&]() -> generator<int> {
+            bool caught = false;
+            try {
+                co_yield elements_of(thrower());
+            } catch (const std::runtime_error &) {
+                caught = true;
+            }
+            if (caught)
+                co_yield -1;
+            co_yield 2;
+        };
+        CHECK_THAT(f() | to<std::vector>(), Catch::Equals(std::vector{1, -1, 2}));
+    }
+}
+
+namespace {
+
+struct copy_counter {
+    int value = 0;
+    int *copies = nullptr;
+
+    copy_counter(int value, int *copies) : value(value), copies(copies) {
+    }
+    copy_counter(const copy_counter &other) : value(other.value), copies(other.copies) {
+        ++*copies;
+    }
+    copy_counter(copy_counter &&) = default;
+    copy_counter &operator=(const copy_counter &other) {
+        value = other.value;
+        copies = other.copies;
+        ++*copies;
+        return *this;
+    }
+    copy_counter &operator=(copy_counter &&) = default;
+};
+
+} // namespace
+
+TEST_CASE("Generators of rvalues", "[Generator]") {
+    int copies = 0;
+
+    SECTION("yielded prvalues are moved to the consumer") {
+        auto f = [](int n, int *copies) -> generator<copy_counter &&> {
+            for (int i = 0; i < n; ++i)
+                co_yield copy_counter{i, copies};
+        };
+        auto v = f(10, &copies) | to<std::vector>();
+        REQUIRE(v.size() == 10);
+        CHECK(v[9].value == 9);
+        CHECK(copies == 0);
+    }
+
+    SECTION("yielded lvalues are copied once") {
+        auto f = [](int n, int *copies) -> generator<copy_counter &&> {
+            copy_counter c{0, copies};
+            for (int i = 0; i < n; ++i) {
+                c.value = i;
+                co_yield c;
+            }
+        };
+        auto v = f(10, &copies) | to<std::vector>();
+        REQUIRE(v.size() == 10);
+        CHECK(v[9].value == 9);
+        CHECK(copies == 10);
+    }
+
+    SECTION("move-only values") {
+        auto f = []() -> generator<std::unique_ptr<int> &&> {
+            for (int i = 0; i < 3; ++i)
+                co_yield std::make_unique<int>(i);
+        };
+        std::vector<int> res;
+        for (auto &&p : f()) {
+            auto owned = std::move(p);
+            res.push_back(*owned);
+        }
+        CHECK_THAT(res, Catch::Equals(std::vector{0, 1, 2}));
+    }
+
+    SECTION("elements_of copies lvalue ranges") {
+        std::vector<std::string> words = {"a", "b"};
+        auto f = [&]() -> generator<std::string &&> {
+            co_yield elements_of(words);
+            co_yield "c";
+        };
+        CHECK_THAT(f() | to<std::vector>(), Catch::Equals(std::vector<std::string>{"a", "b", "c"}));
+        CHECK_THAT(words, Catch::Equals(std::vector<std::string>{"a", "b"}));
+    }
+}
+
+TEST_CASE("Generators announcing their size", "[Generator]") {
+    SECTION("yielded size_hint") {
+        auto f = [](int n, int &started) -> generator<int> {
+            ++started;
+            co_yield exact_size{std::size_t(n)};
+            for (int i = 0; i < n; ++i)
+                co_yield i;
+        };
+        int started = 0;
+        auto g = f(1000, started);
+        CHECK(started == 0);
+        CHECK(g.size_hint() == 1000u);
+        // the coroutine ran up to its first element
+        CHECK(started == 1);
+        CHECK(g.size_hint() == 1000u);
+        auto v = std::move(g) | to<std::vector>();
+        CHECK(started == 1);
+        CHECK(v.size() == 1000u);
+        CHECK(v.capacity() == 1000u);
+        CHECK(v[999] == 999);
+    }
+
+    SECTION("size_hint parameter") {
+        auto f = [](size_hint, int &started) -> generator<int> {
+            ++started;
+            for (int i = 0; i < 10; ++i)
+                co_yield i;
+        };
+        int started = 0;
+        auto g = f(size_hint{64}, started);
+        CHECK(g.size_hint() == 64u);
+        CHECK(started == 0);
+        auto v = std::move(g) | to<std::vector>();
+        CHECK(v.size() == 10u);
+        CHECK(v.capacity() == 64u);
+    }
+
+    SECTION("throwing before the first element") {
+        auto f = []() -> generator<int> {
+            throw std::runtime_error("no element");
+            co_yield 1;
+        };
+        auto g = f();
+        CHECK_THROWS_AS(g.size_hint(), std::runtime_error);
+        CHECK(g.begin() == g.end());
+    }
+
+    SECTION("no hint") {
+        auto f = []() -> generator<int> {
+            co_yield 1;
+            co_yield 2;
+        };
+        auto g = f();
+        CHECK(!g.size_hint());
+        CHECK_THAT(std::move(g) | to<std::vector>(), Catch::Equals(std::vector{1, 2}));
+    }
+}
@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/instrumentation.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::input_range<instrumented_generator<int>>);
+static_assert(r::view<instrumented_generator<int>>);
+
+namespace {
+
+struct instrumented_int {
+    int value;
+    bool operator==(const instrumented_int &) const = default;
+};
+
+instrumented_generator<instrumented_int> ints(int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield instrumented_int{i};
+}
+
+generator_stats stats_of(std::string_view name) {
+    const auto all = instrumentation_registry::instance().snapshot();
+    auto it = r::find_if(all, [&](const auto &s) { return s.name.find(name) != std::string::npos; });
+    REQUIRE(it != all.end());
+    return *it;
+}
+
+} // namespace
+
+TEST_CASE("Generator instrumentation", "[Instrumentation]") {
+    instrumentation_registry::instance().reset();
+
+    CHECK((ints(5) | to<std::vector>()) == std::vector<instrumented_int>{{0}, {1}, {2}, {3}, {4}});
+    CHECK((ints(2) | to<std::vector>()) == std::vector<instrumented_int>{{0}, {1}});
+
+    const auto stats = stats_of("instrumented_int");
+    CHECK(stats.allocations == 2);
+    CHECK(stats.deallocations == 2);
+    CHECK(stats.frame_bytes > 0);
+    CHECK(stats.yields == 7);
+    // one resumption per element, plus the last one
+    CHECK(stats.resumes == 9);
+    CHECK(stats.time.count() > 0);
+
+    const auto json = instrumentation_registry::instance().to_json();
+    CHECK(json.starts_with("{\"generators\": [{\"name\": "));
+    CHECK(json.find("\"yields\": 7") != std::string::npos);
+
+    instrumentation_registry::instance().reset();
+    CHECK(stats_of("instrumented_int").yields == 0);
+}
+
+namespace {
+
+struct never_run {};
+
+[[maybe_unused]] instrumented_generator<never_run> not_called() {
+    co_yield never_run{};
+}
+
+} // namespace
+
+TEST_CASE("Generator counters are registered before use", "[Instrumentation]") {
+    // the notifications are noexcept and must not allocate the counters
+    const auto stats = stats_of("never_run");
+    CHECK(stats.allocations == 0);
+    CHECK(stats.yields == 0);
+}
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/instrumented.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <list>
+#include <sstream>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+namespace {
+
+generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+} // namespace
+
+using vector_view = instrumented_view<r::ref_view<std::vector<int>>>;
+static_assert(r::random_access_range<vector_view>);
+static_assert(r::common_range<vector_view>);
+static_assert(r::sized_range<vector_view>);
+static_assert(r::bidirectional_range<instrumented_view<r::ref_view<std::list<int>>>>);
+static_assert(!r::random_access_range<instrumented_view<r::ref_view<std::list<int>>>>);
+static_assert(!r::forward_range<instrumented_view<r::istream_view<int>>>);
+static_assert(std::same_as<r::range_reference_t<vector_view>, int &>);
+
+TEST_CASE("instrumented counts iterator operations", "[Instrumented]") {
+    std::vector<int> v = {1, 2, 3};
+    iterator_counters c;
+
+    SECTION("range for") {
+        int sum = 0;
+        for (int i : instrumented(v, c))
+            sum += i;
+        CHECK(sum == 6);
+        CHECK(c.begin == 1);
+        CHECK(c.end == 1);
+        CHECK(c.increments == 3);
+        CHECK(c.dereferences == 3);
+        CHECK(c.comparisons == 4);
+        CHECK(c.total() == 12);
+    }
+
+    SECTION("random access") {
+        auto iv = v | instrumented(c);
+        auto it = iv.begin();
+        it += 2;
+        CHECK(it[-1] == 2);
+        CHECK(iv.end() - it == 1);
+        CHECK(it < iv.end());
+        --it;
+        CHECK(c.advances == 1);
+        CHECK(c.dereferences == 1);
+        CHECK(c.distances == 1);
+        CHECK(c.comparisons == 1);
+        CHECK(c.decrements == 1);
+        CHECK(c.end == 2);
+        CHECK(iv.size() == 3);
+    }
+
+    SECTION("input ranges with sentinels") {
+        for (int i : instrumented(iota(4), c))
+            (void)i;
+        CHECK(c.increments == 4);
+        CHECK(c.comparisons == 5);
+    }
+
+    SECTION("reset") {
+        (void)(instrumented(v, c) | to<std::vector>());
+        CHECK(c.total() != 0);
+        c.reset();
+        CHECK(c == iterator_counters{});
+    }
+}
+
+TEST_CASE("instrumented stages of a pipeline", "[Instrumented]") {
+    std::vector<int> a = {1, 2, 3};
+    std::vector<int> b = {4, 5};
+    iterator_counters ca, cb, cp;
+
+    auto p = product(instrumented(a, ca), instrumented(b, cb)) | instrumented(cp);
+    const auto res = p | to<std::vector<std::tuple<int, int>>>();
+    CHECK(res.size() == 6);
+    CHECK(std::get<1>(res.back()) == 5);
+
+    // each element of the product dereferences both ranges
+    CHECK(cp.dereferences == 6);
+    CHECK(ca.dereferences >= 6);
+    CHECK(cb.dereferences >= 6);
+
+    iterator_counters ce;
+    std::size_t n = 0;
+    for (auto [i, e] : enumerate(instrumented(a, ce)))
+        n += i * e;
+    CHECK(n == 8);
+    CHECK(ce.dereferences == 3);
+    CHECK(ce.increments == 3);
+}
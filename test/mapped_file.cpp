@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/mapped_file.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::forward_range<mapped_records_view>);
+static_assert(r::view<mapped_records_view>);
+static_assert(r::random_access_range<decltype(std::declval<mapped_records_view>().indexed())>);
+static_assert(std::same_as<r::range_reference_t<mapped_records_view>, mapped_record>);
+
+namespace {
+
+struct temp_file {
+    std::filesystem::path path;
+
+    explicit temp_file(std::string_view content)
+        : path(std::filesystem::temp_directory_path() /
+               ("rangesnext_mapped_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)))) {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    ~temp_file() {
+        std::filesystem::remove(path);
+    }
+};
+
+using strings = std::vector<std::string_view>;
+
+} // namespace
+
+TEST_CASE("mapped_lines", "[MappedFile]") {
+    auto check = [](std::string_view content, strings expected) {
+        temp_file f(content);
+        auto lines = mapped_lines(f.path);
+        CHECK_THAT(lines | to<strings>(), Catch::Equals(expected));
+        auto indexed = lines.indexed();
+        REQUIRE(indexed.size() == expected.size());
+        for (std::size_t i = expected.size(); i-- > 0;)
+            CHECK(indexed[i] == expected[i]);
+    };
+
+    check("", {});
+    check("\n", {""});
+    check("a", {"a"});
+    check("a\n", {"a"});
+    check("a\nbc\n\ndef", {"a", "bc", "", "def"});
+    check("a\nbc\n\ndef\n\n", {"a", "bc", "", "def", ""});
+}
+
+TEST_CASE("mapped_records", "[MappedFile]") {
+    temp_file f("x,yy,,zzz");
+    auto records = mapped_records(f.path, ',');
+    CHECK_THAT(records | to<strings>(), Catch::Equals(strings{"x", "yy", "", "zzz"}));
+    CHECK(r::distance(records) == 4);
+    CHECK(records.file().size() == 9);
+
+    SECTION("records point into the mapping") {
+        CHECK((*records.begin()).data() == records.file().data());
+    }
+
+    SECTION("works with enumerate") {
+        std::vector<std::size_t> indexes;
+        for (auto [i, record] : enumerate(records)) {
+            if (record.empty())
+                indexes.push_back(i);
+        }
+        CHECK_THAT(indexes, Catch::Equals(std::vector<std::size_t>{2}));
+    }
+
+    SECTION("the mapping outlives the view") {
+        auto indexed = records.indexed();
+        records = {};
+        CHECK(indexed[3] == "zzz");
+    }
+
+    SECTION("the mapping outlives the view, through the records") {
+        const auto copies = mapped_records(f.path, ',') | to<std::vector>();
+        static_assert(std::same_as<decltype(copies), const std::vector<mapped_record>>);
+        REQUIRE(copies.size() == 4);
+        CHECK(copies[1] == "yy");
+        CHECK(copies[3] == "zzz");
+    }
+}
+
+TEST_CASE("Default constructed mapped_records_view", "[MappedFile]") {
+    mapped_records_view records;
+    CHECK(records.begin() == records.end());
+    CHECK(r::distance(records) == 0);
+    CHECK(records.indexed().empty());
+    CHECK(records.file().size() == 0);
+}
+
+TEST_CASE("mapped_file errors", "[MappedFile]") {
+    CHECK_THROWS_AS(mapped_lines("/this/file/does/not/exist"), std::system_error);
+}
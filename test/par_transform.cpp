@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/par_transform.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+namespace {
+
+generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+// slower for small values, so that results complete out of order
+std::string slow_to_string(int i) {
+    std::this_thread::sleep_for(std::chrono::microseconds((10 - i % 10) * 50));
+    return std::to_string(i);
+}
+
+} // namespace
+
+static_assert(r::input_range<par_transform_view<generator<int>, decltype(&slow_to_string)>>);
+
+TEST_CASE("par_transform", "[ParTransform]") {
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; ++i)
+        expected.push_back(std::to_string(i));
+
+    CHECK_THAT(iota(200) | par_transform(slow_to_string, 4, 8) | to<std::vector>(), Catch::Equals(expected));
+    CHECK_THAT(par_transform(iota(200), slow_to_string) | to<std::vector>(), Catch::Equals(expected));
+    CHECK((iota(0) | par_transform(slow_to_string, 2) | to<std::vector>()).empty());
+
+    SECTION("works with enumerate") {
+        std::vector<int> v = {1, 2, 3, 4};
+        for (auto [i, value] : enumerate(v | par_transform([](int x) { return x * 10; }, 2))) {
+            CHECK(value == v[i] * 10);
+        }
+    }
+
+    SECTION("bounded window") {
+        std::atomic<int> running = 0, max_running = 0;
+        auto f = [&](int i) {
+            int r = ++running;
+            int m = max_running.load();
+            while (r > m && !max_running.compare_exchange_weak(m, r)) {
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            --running;
+            return i;
+        };
+        auto res = iota(100) | par_transform(f, 8, 3) | to<std::vector>();
+        CHECK(res.size() == 100);
+        CHECK(max_running.load() <= 3);
+    }
+
+    SECTION("exceptions") {
+        auto f = [](int i) {
+            if (i == 42)
+                throw std::runtime_error("42");
+            return i;
+        };
+        std::vector<int> seen;
+        CHECK_THROWS_AS(
+            [&] {
+                for (int i : iota(100) | par_transform(f, 4))
+                    seen.push_back(i);
+            }(),
+            std::runtime_error);
+        CHECK(seen.size() == 42);
+    }
+
+    SECTION("throwing source") {
+        auto throwing = []() -> generator<int> {
+            co_yield 1;
+            co_yield 2;
+            throw std::runtime_error("source");
+        };
+        std::vector<int> seen;
+        CHECK_THROWS_AS(
+            [&] {
+                for (int i : par_transform_view(throwing(), [](int x) { return x * 10; }, 2, 4))
+                    seen.push_back(i);
+            }(),
+            std::runtime_error);
+        // the elements read before the exception are delivered
+        CHECK_THAT(seen, Catch::Equals(std::vector{10, 20}));
+    }
+
+    SECTION("destroyed before the end") {
+        auto view = iota(1000) | par_transform(slow_to_string, 4, 16);
+        auto it = view.begin();
+        CHECK(*it == "0");
+    }
+}
+
+TEST_CASE("Default constructed par_transform_view", "[ParTransform]") {
+    par_transform_view<generator<int>, decltype(&slow_to_string)> view;
+    CHECK(view.begin() == view.end());
+}
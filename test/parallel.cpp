@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/parallel.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+TEST_CASE("par::for_each", "[Parallel]") {
+    thread_pool pool(4);
+
+    SECTION("visits each element once") {
+        std::vector<std::atomic<int>> visits(10000);
+        par::for_each(r::views::iota(0, 10000), [&](int i) { ++visits[i]; }, 0, pool);
+        CHECK(r::all_of(visits, [](const auto &v) { return v == 1; }));
+    }
+
+    SECTION("product_view") {
+        std::vector<int> a(100), b(50);
+        std::iota(a.begin(), a.end(), 0);
+        std::iota(b.begin(), b.end(), 0);
+        std::atomic<long> sum = 0;
+        par::for_each(
+            product(a, b),
+            [&](auto t) {
+                auto [x, y] = t;
+                sum += x * 1000 + y;
+            },
+            16, pool);
+        CHECK(sum == 50 * 1000 * (99 * 100 / 2) + 100 * (49 * 50 / 2));
+    }
+
+    SECTION("enumerate") {
+        std::vector<int> v(1000, 1);
+        par::for_each(enumerate(v), [](auto e) { e.value += int(e.index); }, 7, pool);
+        for (std::size_t i = 0; i < v.size(); ++i)
+            CHECK(v[i] == int(i) + 1);
+    }
+
+    SECTION("input ranges are processed sequentially") {
+        auto gen = []() -> generator<int> {
+            for (int i = 0; i < 5; ++i)
+                co_yield i;
+        };
+        std::vector<int> seen;
+        par::for_each(gen(), [&](int i) { seen.push_back(i); }, 0, pool);
+        CHECK_THAT(seen, Catch::Equals(std::vector{0, 1, 2, 3, 4}));
+    }
+
+    SECTION("exceptions are rethrown") {
+        CHECK_THROWS_AS(par::for_each(
+                            r::views::iota(0, 1000),
+                            [](int i) {
+                                if (i == 777)
+                                    throw std::runtime_error("777");
+                            },
+                            10, pool),
+                        std::runtime_error);
+    }
+}
+
+TEST_CASE("par::transform_reduce and count_if", "[Parallel]") {
+    thread_pool pool(3);
+    const auto numbers = r::views::iota(0, 100000);
+
+    CHECK(par::transform_reduce(numbers, 0L, std::plus<>{}, [](int i) { return long(i); }, 0, pool) ==
+          100000L * 99999 / 2);
+    CHECK(par::count_if(numbers, [](int i) { return i % 3 == 0; }, 100, pool) == 33334);
+
+    SECTION("the order of the reduction is preserved") {
+        auto digits = r::views::iota(0, 500);
+        auto concat = [](std::string a, const std::string &b) { return a + b; };
+        auto to_string = [](int i) { return std::to_string(i % 10); };
+        std::string expected;
+        for (int i : digits)
+            expected += to_string(i);
+        CHECK(par::transform_reduce(digits, std::string(">"), concat, to_string, 7, pool) == ">" + expected);
+    }
+
+    SECTION("nested parallel algorithms") {
+        auto count = par::transform_reduce(
+            r::views::iota(0, 20), std::size_t(0), std::plus<>{},
+            [&](int) { return par::count_if(r::views::iota(0, 1000), [](int i) { return i % 2 == 0; }, 10, pool); },
+            1, pool);
+        CHECK(count == 20 * 500);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/pipeline.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+namespace {
+
+generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+auto square = [](int i) { return i * i; };
+auto is_even = [](int i) { return i % 2 == 0; };
+auto to_string = [](int i) { return std::to_string(i); };
+
+} // namespace
+
+TEST_CASE("Fused pipelines", "[Pipeline]") {
+    auto p = iota(10) | co_transform(square) | co_filter(is_even) | co_transform(to_string);
+    static_assert(std::same_as<decltype(p), fused_pipeline<generator<int>, detail::transform_stage<decltype(square)>,
+                                                           detail::filter_stage<decltype(is_even)>,
+                                                           detail::transform_stage<decltype(to_string)>>>);
+    static_assert(std::same_as<r::range_reference_t<decltype(p)>, std::string &&>);
+    CHECK_THAT(std::move(p) | to<std::vector>(),
+               Catch::Equals(std::vector<std::string>{"0", "4", "16", "36", "64"}));
+
+    SECTION("stages can be composed before being applied") {
+        auto stages = co_filter(is_even) | co_transform(square);
+        CHECK_THAT(iota(7) | stages | to<std::vector>(), Catch::Equals(std::vector{0, 4, 16, 36}));
+    }
+
+    SECTION("lvalue results are yielded by reference") {
+        std::vector<std::string> words = {"a", "bb", "ccc"};
+        auto p = words | co_filter([](const std::string &s) { return s.size() > 1; });
+        static_assert(std::same_as<r::range_reference_t<decltype(p)>, std::string &>);
+        for (auto &s : p)
+            s += "!";
+        CHECK_THAT(words, Catch::Equals(std::vector<std::string>{"a", "bb!", "ccc!"}));
+    }
+
+    SECTION("references into a temporary are copied") {
+        struct named {
+            std::string name;
+        };
+        auto p = iota(3) | co_transform([](int i) { return named{std::string(20, char('a' + i))}; }) |
+                 co_transform([](const named &n) -> const std::string & { return n.name; });
+        static_assert(std::same_as<r::range_reference_t<decltype(p)>, std::string &&>);
+        CHECK_THAT(std::move(p) | to<std::vector>(),
+                   Catch::Equals(std::vector<std::string>{std::string(20, 'a'), std::string(20, 'b'),
+                                                          std::string(20, 'c')}));
+
+        // the elements of the base outlive the yield
+        std::vector<named> names = {{"x"}, {"y"}};
+        auto q = names | co_transform([](const named &n) -> const std::string & { return n.name; });
+        static_assert(std::same_as<r::range_reference_t<decltype(q)>, const std::string &>);
+    }
+
+    SECTION("copyable bases can be iterated again") {
+        std::vector<int> v = {1, 2, 3};
+        auto p = v | co_transform(square);
+        CHECK_THAT(p | to<std::vector>(), Catch::Equals(std::vector{1, 4, 9}));
+        CHECK_THAT(p | to<std::vector>(), Catch::Equals(std::vector{1, 4, 9}));
+    }
+
+    SECTION("move-only results") {
+        auto p = iota(3) | co_transform([](int i) { return std::make_unique<int>(i); }) |
+                 co_filter([](const std::unique_ptr<int> &p) { return *p != 1; });
+        std::vector<std::unique_ptr<int>> v = std::move(p) | to<std::vector>();
+        REQUIRE(v.size() == 2);
+        CHECK(*v[1] == 2);
+    }
+
+    SECTION("works with enumerate") {
+        std::vector<std::size_t> indexes;
+        for (auto [i, value] : enumerate(iota(5) | co_transform(square))) {
+            CHECK(value == int(i * i));
+            indexes.push_back(i);
+        }
+        CHECK(indexes.size() == 5);
+    }
+}
@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/prefetch.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::input_range<prefetch_view<generator<int>>>);
+static_assert(!r::forward_range<prefetch_view<generator<int>>>);
+static_assert(r::view<prefetch_view<generator<int>>>);
+
+namespace {
+
+generator<std::string> strings(int n, std::thread::id &producer) {
+    producer = std::this_thread::get_id();
+    for (int i = 0; i < n; ++i) {
+        co_yield std::to_string(i);
+    }
+}
+
+} // namespace
+
+TEST_CASE("prefetch", "[Prefetch]") {
+    for (int n : {0, 1, 3, 4, 5, 1000}) {
+        std::vector<std::string> expected;
+        for (int i = 0; i < n; ++i)
+            expected.push_back(std::to_string(i));
+
+        std::thread::id producer;
+        CHECK_THAT(strings(n, producer) | prefetch(4) | to<std::vector>(), Catch::Equals(expected));
+        CHECK(producer != std::this_thread::get_id());
+        CHECK_THAT(prefetch(strings(n, producer), 1) | to<std::vector>(), Catch::Equals(expected));
+        CHECK_THAT(strings(n, producer) | prefetch | to<std::vector>(), Catch::Equals(expected));
+    }
+
+    SECTION("works with enumerate") {
+        std::vector<int> v = {10, 20, 30};
+        std::vector<std::pair<std::size_t, int>> res;
+        for (auto [i, value] : enumerate(prefetch(v))) {
+            res.emplace_back(i, value);
+        }
+        CHECK_THAT(res, Catch::Equals(std::vector<std::pair<std::size_t, int>>{{0, 10}, {1, 20}, {2, 30}}));
+    }
+}
+
+TEST_CASE("Default constructed prefetch_view", "[Prefetch]") {
+    prefetch_view<r::ref_view<std::vector<int>>> view;
+    CHECK(view.begin() == view.end());
+}
+
+TEST_CASE("prefetch bounds the producer", "[Prefetch]") {
+    std::atomic<int> produced = 0;
+    auto gen = [](std::atomic<int> &produced) -> generator<int> {
+        for (int i = 0; i < 100; ++i) {
+            ++produced;
+            co_yield i;
+        }
+    };
+
+    auto view = prefetch(gen(produced), 8);
+    auto it = view.begin();
+    CHECK(*it == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // 8 elements in the queue, plus the one waiting to be pushed
+    CHECK(produced.load() <= 9);
+    ++it;
+    CHECK(*it == 1);
+    // destroying the view stops the producer
+}
+
+TEST_CASE("prefetch propagates exceptions", "[Prefetch]") {
+    auto gen = []() -> generator<int> {
+        co_yield 1;
+        co_yield 2;
+        throw std::runtime_error("failed");
+    };
+
+    std::vector<int> seen;
+    auto view = prefetch(gen());
+    CHECK_THROWS_AS(
+        [&] {
+            for (int i : view)
+                seen.push_back(i);
+        }(),
+        std::runtime_error);
+    CHECK_THAT(seen, Catch::Equals(std::vector{1, 2}));
+}
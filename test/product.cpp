@@ -5,11 +5,14 @@ Licenced under Boost Software License license. See LICENSE.md for details.
 */
 
 #include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
 #include <cor3ntin/rangesnext/product.hpp>
 #include <cor3ntin/rangesnext/to.hpp>
 
 #include <iostream>
+#include <memory_resource>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 using namespace cor3ntin::rangesnext;
@@ -87,3 +90,69 @@ TEST_CASE("Basic Product Tests", "product") {
                    Catch::Equals(expected));
     }
 }
+
+TEST_CASE("Input inner ranges", "product") {
+    std::vector<std::tuple<char, int>> expected = {
+        {'+', 1}, {'+', 2}, {'+', 3}, {'-', 1}, {'-', 2}, {'-', 3}};
+
+    SECTION("istream_view") {
+        auto symbols = std::vector{'+', '-'};
+        auto ints = std::istringstream{"1 2 3"};
+        auto iv = r::istream_view<int>(ints);
+
+        auto v = product(symbols, iv);
+
+        using R = decltype(v);
+        static_assert(r::forward_range<R>);
+        static_assert(std::same_as<r::range_reference_t<R>,
+                                   std::tuple<char &, const int &>>);
+
+        CHECK_THAT((v | to<std::vector<std::tuple<char, int>>>()),
+                   Catch::Equals(expected));
+    }
+
+    SECTION("generator with an arena") {
+        auto g = []() -> generator<int> {
+            for (int i = 1; i <= 3; ++i)
+                co_yield i;
+        };
+        auto symbols = std::istringstream{"+ -"};
+        auto sv = r::istream_view<char>(symbols);
+
+        std::pmr::monotonic_buffer_resource arena;
+        auto v = product(std::allocator_arg,
+                         std::pmr::polymorphic_allocator<>(&arena), sv, g());
+
+        CHECK_THAT((v | to<std::vector<std::tuple<char, int>>>()),
+                   Catch::Equals(expected));
+    }
+
+    SECTION("Several input ranges") {
+        auto a = std::istringstream{"1 2"};
+        auto b = std::istringstream{"3 4"};
+        auto c = std::istringstream{"5 6"};
+        auto v = product(r::istream_view<int>(a), r::istream_view<int>(b),
+                         r::istream_view<int>(c));
+        CHECK(r::distance(v) == 8);
+    }
+
+    SECTION("copies share the buffer") {
+        auto symbols = std::vector{'+', '-'};
+        auto ints = std::istringstream{"1 2 3"};
+        auto v = product(symbols, r::istream_view<int>(ints));
+        auto copy = v;
+        CHECK_THAT((copy | to<std::vector<std::tuple<char, int>>>()),
+                   Catch::Equals(expected));
+        CHECK_THAT((v | to<std::vector<std::tuple<char, int>>>()),
+                   Catch::Equals(expected));
+    }
+
+    SECTION("throwing inner range") {
+        auto g = []() -> generator<int> {
+            co_yield 1;
+            throw std::runtime_error("inner");
+        };
+        auto symbols = std::vector{'+', '-'};
+        CHECK_THROWS_AS(product(symbols, g()), std::runtime_error);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/product_indices.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+TEST_CASE("Product indices", "[ProductIndices]") {
+    auto v = product_indices(2, 3, 4);
+
+    using R = decltype(v);
+    static_assert(r::random_access_range<R>);
+    static_assert(r::sized_range<R>);
+    static_assert(r::common_range<R>);
+    static_assert(std::same_as<r::range_reference_t<R>, std::array<int, 3>>);
+
+    std::vector<std::array<int, 3>> expected;
+    for (int i = 0; i < 2; ++i)
+        for (int j = 0; j < 3; ++j)
+            for (int k = 0; k < 4; ++k)
+                expected.push_back({i, j, k});
+
+    CHECK(v.size() == 24);
+    CHECK_THAT(v | to<std::vector>(), Catch::Equals(expected));
+    CHECK_THAT(v | r::views::reverse | to<std::vector>(),
+               Catch::Equals(r::reverse_view(expected) | to<std::vector>()));
+
+    auto first = v.begin();
+    for (std::size_t n = 0; n <= expected.size(); ++n) {
+        auto it = first + static_cast<std::ptrdiff_t>(n);
+        CHECK(it - first == static_cast<std::ptrdiff_t>(n));
+        CHECK(it.linear_index() == static_cast<std::ptrdiff_t>(n));
+        if (n < expected.size())
+            CHECK(*it == expected[n]);
+    }
+    CHECK(first + 24 == v.end());
+    CHECK(*(v.end() - 1) == std::array{1, 2, 3});
+
+    for (auto [i, j, k] : v) {
+        CHECK(i < 2);
+        CHECK(j < 3);
+        CHECK(k < 4);
+    }
+}
+
+TEST_CASE("Product indices matches product of iota", "[ProductIndices]") {
+    auto iota = product(r::views::iota(0, 3), r::views::iota(0, 5));
+    auto indices = product_indices(3, 5);
+    CHECK(r::equal(iota, indices, [](auto &&a, auto &&b) {
+        return std::get<0>(a) == b[0] && std::get<1>(a) == b[1];
+    }));
+}
+
+TEST_CASE("Product indices with static extents", "[ProductIndices]") {
+    auto v = product_indices(static_extents<std::size_t, 2, 2>{});
+    static_assert(std::same_as<r::range_reference_t<decltype(v)>, std::array<std::size_t, 2>>);
+    static_assert(decltype(v)::rank == 2);
+
+    std::vector<std::array<std::size_t, 2>> expected{{0, 0}, {0, 1}, {1, 0}, {1, 1}};
+    CHECK_THAT(v | to<std::vector>(), Catch::Equals(expected));
+}
+
+TEST_CASE("Product indices with empty extents", "[ProductIndices]") {
+    CHECK(r::empty(product_indices(3, 0, 2)));
+    CHECK(product_indices(3, 0, 2).size() == 0);
+    CHECK(r::distance(product_indices(std::size_t(7))) == 7);
+}
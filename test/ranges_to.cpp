@@ -8,15 +8,24 @@ Licenced under Boost Software License license. See LICENSE.md for details.
 
 #include <algorithm>
 #include <array>
+#include <cor3ntin/rangesnext/enumerate.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
 #include <cor3ntin/rangesnext/to.hpp>
+#include <deque>
 #include <forward_list>
+#include <functional>
 #include <list>
 #include <map>
 #include <queue>
 #include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <sstream>
 #include <stack>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace r = std::ranges;
@@ -132,6 +141,16 @@ TEST_CASE("Conversion from vector to associative containers with unspecified "
     vec | rangesnext::to<std::vector<std::pair<int, int>>>(alloc());
 }
 
+TEST_CASE("Arguments passed as lvalues") {
+    std::vector<std::pair<int, int>> vec{{1, 1}, {2, 2}};
+    std::greater<int> comp;
+    auto m = rangesnext::to<std::map>(vec, comp);
+    STATIC_REQUIRE(std::same_as<decltype(m), std::map<int, int, std::greater<int>>>);
+    CHECK(m.begin()->first == 2);
+    auto closure = rangesnext::to<std::map>(comp);
+    CHECK((vec | std::move(closure)) == m);
+}
+
 TEST_CASE("Non-sized ranges") {
     auto ints = std::vector{1, 2, 3, 4, 5, 6};
     auto view = ints | std::views::filter([](int x) { return (x % 2) != 0; });
@@ -150,6 +169,14 @@ TEST_CASE("Nested views") {
     std::list<std::list<int>> lst = {{0, 1, 2, 3}, {4, 5, 6, 7}};
     auto vec1 = rangesnext::to<std::vector<std::vector<int>>>(lst);
     auto vec2 = rangesnext::to<std::vector<std::vector<double>>>(lst);
+    CHECK(vec1 == std::vector<std::vector<int>>{{0, 1, 2, 3}, {4, 5, 6, 7}});
+    CHECK(vec2 == std::vector<std::vector<double>>{{0, 1, 2, 3}, {4, 5, 6, 7}});
+
+    auto deq = lst | rangesnext::to<std::deque<std::set<long>>>();
+    CHECK(deq.back() == std::set<long>{4, 5, 6, 7});
+
+    STATIC_REQUIRE(!rangesnext::detail::recursive_container_convertible<std::vector<int>,
+                                                                        std::vector<std::vector<std::vector<int>>>>);
 }
 
 template<typename T>
@@ -181,3 +208,164 @@ TEST_CASE("from_range_t") {
     CHECK_THAT((lst | rangesnext::to<vector_with_range_ctr>()),
                Catch::Matchers::Equals(vector_with_range_ctr<int>{0, 1, 2, 3, 4}));
 }
+
+namespace {
+
+constexpr auto multiplication_table = rangesnext::product(r::views::iota(1, 4), r::views::iota(1, 5)) |
+                                      r::views::transform([](auto p) {
+                                          auto [a, b] = p;
+                                          return a * b;
+                                      }) |
+                                      rangesnext::to_array<12>();
+
+constexpr auto enumerated = rangesnext::to_array<3>(rangesnext::enumerate(r::views::iota(5, 8)));
+
+} // namespace
+
+TEST_CASE("Conversion to std::array") {
+    STATIC_REQUIRE(std::same_as<decltype(multiplication_table), const std::array<int, 12>>);
+    STATIC_REQUIRE(multiplication_table[0] == 1);
+    STATIC_REQUIRE(multiplication_table[6] == 6);
+    STATIC_REQUIRE(multiplication_table[11] == 12);
+    STATIC_REQUIRE(enumerated[2].index == 2);
+    STATIC_REQUIRE(enumerated[2].value == 7);
+
+    std::list<std::string> lst = {"a", "b"};
+    CHECK((lst | rangesnext::to<std::array<std::string, 2>>()) == std::array<std::string, 2>{"a", "b"});
+    CHECK_THROWS_AS((lst | rangesnext::to_array<3>()), std::length_error);
+    CHECK_THROWS_AS((lst | rangesnext::to_array<1>()), std::length_error);
+
+    std::vector<std::vector<int>> nested = {{1, 2}, {3, 4}};
+    CHECK((nested | rangesnext::to<std::vector<std::array<int, 2>>>()) ==
+          std::vector<std::array<int, 2>>{{1, 2}, {3, 4}});
+}
+
+namespace {
+
+// Counts calls to reserve, to check that unordered containers are presized
+template <typename Key, typename T>
+struct counting_unordered_map : std::unordered_map<Key, T> {
+    using std::unordered_map<Key, T>::unordered_map;
+    void reserve(std::size_t n) {
+        ++reserved;
+        std::unordered_map<Key, T>::reserve(n);
+    }
+    int reserved = 0;
+};
+
+} // namespace
+
+TEST_CASE("Unordered containers reserve their buckets") {
+    STATIC_REQUIRE(rangesnext::detail::bucket_reservable_container<std::unordered_set<int>>);
+    STATIC_REQUIRE(!rangesnext::detail::reservable_container<std::unordered_set<int>>);
+
+    auto squares = r::views::iota(0, 1000) | r::views::transform([](int i) { return std::pair{i, i * i}; });
+    auto m = squares | rangesnext::to<counting_unordered_map<int, int>>();
+    CHECK(m.reserved == 1);
+    CHECK(m.size() == 1000);
+    CHECK(m.at(30) == 900);
+
+    auto s = r::views::iota(0, 1000) | r::views::transform([](int i) { return i % 100; }) |
+             rangesnext::to<std::unordered_set>();
+    STATIC_REQUIRE(std::same_as<decltype(s), std::unordered_set<int>>);
+    CHECK(s.size() == 100);
+}
+
+TEST_CASE("Grouping") {
+    std::vector<std::string> words = {"apple", "bee", "art", "cat", "bird", "arm", "ant"};
+    auto first_letter = [](const std::string &w) { return w[0]; };
+
+    SECTION("deduced") {
+        auto groups = words | rangesnext::to<std::unordered_map>(rangesnext::group_by(first_letter));
+        STATIC_REQUIRE(std::same_as<decltype(groups), std::unordered_map<char, std::vector<std::string>>>);
+        CHECK(groups.size() == 3);
+        CHECK(groups['a'] == std::vector<std::string>{"apple", "art", "arm", "ant"});
+        CHECK(groups['b'] == std::vector<std::string>{"bee", "bird"});
+        CHECK(groups['c'] == std::vector<std::string>{"cat"});
+    }
+
+    SECTION("values") {
+        auto sizes = rangesnext::to<std::map>(words, rangesnext::group_by(first_letter, [](const std::string &w) { return w.size(); }),
+                                              std::greater<char>{});
+        STATIC_REQUIRE(
+            std::same_as<decltype(sizes), std::map<char, std::vector<std::size_t>, std::greater<char>>>);
+        CHECK(sizes.begin()->first == 'c');
+        CHECK(sizes['a'] == std::vector<std::size_t>{5, 3, 3, 3});
+    }
+
+    SECTION("explicit container types") {
+        using groups_t = std::unordered_map<int, std::set<int>>;
+        auto groups = r::views::iota(0, 20) | rangesnext::to<groups_t>(rangesnext::group_by([](int i) { return i % 3; }));
+        CHECK(groups.size() == 3);
+        CHECK(groups[1] == std::set<int>{1, 4, 7, 10, 13, 16, 19});
+    }
+
+    SECTION("runs of equivalent keys") {
+        // sorted by key: each group is looked up and reserved once
+        std::vector<std::pair<int, int>> sorted = {{1, 1}, {1, 2}, {1, 3}, {2, 4}, {3, 5}, {3, 6}, {1, 7}};
+        auto groups = rangesnext::to<std::unordered_map<int, std::vector<int>>>(
+            sorted, rangesnext::group_by([](const auto &p) { return p.first; }, [](const auto &p) { return p.second; }));
+        CHECK(groups.size() == 3);
+        CHECK(groups[1] == std::vector{1, 2, 3, 7});
+        CHECK(groups[2] == std::vector{4});
+        CHECK(groups[3] == std::vector{5, 6});
+    }
+
+    SECTION("input ranges") {
+        auto input = std::istringstream{"1 2 3 4 5 6"};
+        auto groups = r::istream_view<int>(input) |
+                      rangesnext::to<std::map>(rangesnext::group_by([](int i) { return i % 2 == 0; }));
+        CHECK(groups[false] == std::vector{1, 3, 5});
+        CHECK(groups[true] == std::vector{2, 4, 6});
+    }
+
+    SECTION("empty") {
+        auto groups = std::vector<int>{} | rangesnext::to<std::unordered_map>(rangesnext::group_by(std::identity{}));
+        CHECK(groups.empty());
+    }
+}
+
+TEST_CASE("Joining strings") {
+    std::vector<std::string> words = {"one", "two", "three"};
+
+    SECTION("to<std::string>") {
+        CHECK((words | rangesnext::to<std::string>()) == "onetwothree");
+        CHECK(rangesnext::to<std::string>(std::list<std::string_view>{"a", "bc"}) == "abc");
+        CHECK((std::vector<const char *>{"x", "y"} | rangesnext::to<std::string>()) == "xy");
+        CHECK((std::vector<std::string>{} | rangesnext::to<std::string>()).empty());
+        // ranges of characters are not joined
+        CHECK((std::vector{'a', 'b'} | rangesnext::to<std::string>()) == "ab");
+        STATIC_REQUIRE(!rangesnext::detail::joined_string_convertible<std::string, std::vector<char>>);
+    }
+
+    SECTION("join_to_string") {
+        CHECK(rangesnext::join_to_string(words, ", ") == "one, two, three");
+        CHECK(rangesnext::join_to_string(words, '/') == "one/two/three");
+        CHECK(rangesnext::join_to_string(words) == "onetwothree");
+        CHECK((words | rangesnext::join_to_string(std::string(" - "))) == "one - two - three");
+        CHECK((words | rangesnext::join_to_string('\n')) == "one\ntwo\nthree");
+        CHECK(rangesnext::join_to_string(std::vector<std::string>{"alone"}, ", ") == "alone");
+        CHECK(rangesnext::join_to_string(std::vector<std::string>{}, ", ").empty());
+    }
+
+    SECTION("prvalue strings") {
+        auto upper = words | r::views::transform([](std::string w) {
+                         r::transform(w, w.begin(), [](char c) { return static_cast<char>(c - 'a' + 'A'); });
+                         return w;
+                     });
+        CHECK(rangesnext::join_to_string(upper, ' ') == "ONE TWO THREE");
+    }
+
+    SECTION("input ranges") {
+        auto input = std::istringstream{"a bb ccc"};
+        CHECK((r::istream_view<std::string>(input) | rangesnext::join_to_string(',')) == "a,bb,ccc");
+    }
+
+    SECTION("constant expressions") {
+        constexpr auto size = [] {
+            std::array<std::string_view, 3> a = {"ab", "c", "def"};
+            return rangesnext::join_to_string(a, ", ").size();
+        }();
+        STATIC_REQUIRE(size == 10);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/sample.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+TEST_CASE("Random order visits every element once", "[Sample]") {
+    std::vector a{1, 2, 3, 4, 5};
+    std::vector b{'a', 'b', 'c'};
+    std::vector c{0.5, 1.5};
+    auto p = product(a, b, c);
+
+    using T = std::vector<std::tuple<int, char, double>>;
+    auto expected = p | to<T>();
+
+    auto shuffled = random_order(p);
+    static_assert(r::random_access_range<decltype(shuffled)>);
+    static_assert(r::sized_range<decltype(shuffled)>);
+    CHECK(shuffled.size() == expected.size());
+
+    auto result = shuffled | to<T>();
+    CHECK(result != expected);
+    r::sort(result);
+    CHECK_THAT(result, Catch::Equals(expected));
+
+    std::mt19937_64 engine(42);
+    auto other = random_order(p, engine) | to<T>();
+    CHECK(other != (shuffled | to<T>()));
+    r::sort(other);
+    CHECK_THAT(other, Catch::Equals(expected));
+}
+
+TEST_CASE("Random order of small ranges", "[Sample]") {
+    for (int n = 0; n < 70; ++n) {
+        auto v = r::views::iota(0, n) | to<std::vector>();
+        auto result = v | random_order | to<std::vector>();
+        r::sort(result);
+        CHECK_THAT(result, Catch::Equals(v));
+    }
+}
+
+TEST_CASE("Sample a huge product space", "[Sample]") {
+    auto i = r::views::iota(std::int64_t(0), std::int64_t(100000));
+    auto p = product(i, i, i);
+    REQUIRE(p.size() == std::uint64_t(100000) * 100000 * 100000);
+
+    std::mt19937 engine(1234);
+    auto s = sample(p, 1000, engine);
+    CHECK(r::distance(s) == 1000);
+
+    auto values = s | to<std::set<std::tuple<std::int64_t, std::int64_t, std::int64_t>>>();
+    CHECK(values.size() == 1000);
+    CHECK(r::all_of(values, [](const auto &t) {
+        auto [x, y, z] = t;
+        return x >= 0 && x < 100000 && y >= 0 && y < 100000 && z >= 0 && z < 100000;
+    }));
+
+    std::vector small{1, 2, 3};
+    CHECK(r::distance(sample(small, 10, engine)) == 3);
+}
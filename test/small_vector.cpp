@@ -0,0 +1,172 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/small_vector.hpp>
+#include <cor3ntin/rangesnext/to.hpp>
+
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+static_assert(r::contiguous_range<small_vector<int, 4>>);
+static_assert(r::contiguous_range<static_vector<int, 4>>);
+static_assert(detail::insertable_container<small_vector<int, 4>>);
+static_assert(detail::reservable_container<small_vector<int, 4>>);
+static_assert(detail::insertable_container<static_vector<int, 4>>);
+static_assert(detail::reservable_container<static_vector<int, 4>>);
+static_assert(std::is_nothrow_move_constructible_v<small_vector<std::string, 4>>);
+// static_vector does not store a pointer or a capacity
+static_assert(sizeof(static_vector<int, 4>) == sizeof(std::size_t) + 4 * sizeof(int));
+
+namespace {
+
+generator<int> iota(int n) {
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+} // namespace
+
+TEST_CASE("small_vector", "[small_vector]") {
+    small_vector<std::string, 2> v;
+    CHECK(v.empty());
+    CHECK(v.capacity() == 2);
+    CHECK(v.is_inline());
+
+    v.push_back("a");
+    v.emplace_back(3, 'b');
+    CHECK(v.is_inline());
+    CHECK(v == small_vector<std::string, 2>{"a", "bbb"});
+
+    SECTION("spills to the heap") {
+        v.push_back(v.front());
+        CHECK(!v.is_inline());
+        CHECK(v.capacity() >= 3);
+        CHECK(v == small_vector<std::string, 2>{"a", "bbb", "a"});
+    }
+
+    SECTION("insert and erase") {
+        v.insert(v.begin(), "z");
+        v.insert(v.begin() + 1, v.back());
+        CHECK(v == small_vector<std::string, 2>{"z", "bbb", "a", "bbb"});
+        v.erase(v.begin(), v.begin() + 2);
+        CHECK(v == small_vector<std::string, 2>{"a", "bbb"});
+        v.erase(v.end() - 1);
+        CHECK(v.size() == 1);
+        v.resize(3, "c");
+        CHECK(v == small_vector<std::string, 2>{"a", "c", "c"});
+        v.resize(1);
+        CHECK(v.back() == "a");
+    }
+
+    SECTION("moving a heap vector steals its buffer") {
+        v.reserve(10);
+        const std::string *data = v.data();
+        auto w = std::move(v);
+        CHECK(w.data() == data);
+        CHECK(v.empty());
+        CHECK(v.is_inline());
+        CHECK(w.size() == 2);
+    }
+
+    SECTION("moving an inline vector moves the elements") {
+        auto w = std::move(v);
+        CHECK(w.is_inline());
+        CHECK(w == small_vector<std::string, 2>{"a", "bbb"});
+        CHECK(v.empty());
+        w = w;
+        v = w;
+        CHECK(v == w);
+        swap(v, w);
+        CHECK(v == w);
+    }
+
+    SECTION("comparisons") {
+        CHECK(v < small_vector<std::string, 2>{"b"});
+        CHECK(v > small_vector<std::string, 2>{"a"});
+    }
+}
+
+TEST_CASE("static_vector", "[small_vector]") {
+    static_vector<int, 3> v = {1, 2};
+    CHECK(v.capacity() == 3);
+    CHECK(v.max_size() == 3);
+    v.push_back(3);
+    CHECK_THROWS_AS(v.push_back(4), std::length_error);
+    CHECK_THROWS_AS(v.reserve(4), std::length_error);
+    CHECK(v.size() == 3);
+    CHECK(v.at(2) == 3);
+    CHECK_THROWS_AS(v.at(3), std::out_of_range);
+
+    auto w = std::move(v);
+    CHECK(w.size() == 3);
+    CHECK(v.empty());
+}
+
+TEST_CASE("small_vector and static_vector as targets of to", "[small_vector]") {
+    SECTION("from sized ranges") {
+        auto v = std::views::iota(0, 4) | to<small_vector<int, 8>>();
+        CHECK(v.is_inline());
+        CHECK(v == small_vector<int, 8>{0, 1, 2, 3});
+
+        auto s = to<static_vector<int, 4>>(std::views::iota(0, 4));
+        CHECK(s == static_vector<int, 4>{0, 1, 2, 3});
+        CHECK_THROWS_AS((to<static_vector<int, 4>>(std::views::iota(0, 5))), std::length_error);
+
+        auto h = std::views::iota(0, 20) | to<small_vector<int, 8>>();
+        CHECK(!h.is_inline());
+        CHECK(h.capacity() == 20);
+    }
+
+    SECTION("from input ranges") {
+        auto v = iota(3) | to<small_vector<int, 4>>();
+        CHECK(v == small_vector<int, 4>{0, 1, 2});
+        auto s = iota(3) | to<static_vector<long, 4>>();
+        CHECK(s.size() == 3);
+        CHECK(s.back() == 2);
+    }
+
+    SECTION("from_range construction") {
+        std::list<int> l = {1, 2, 3};
+        small_vector<int, 2> v(from_range, l);
+        CHECK(v == small_vector<int, 2>{1, 2, 3});
+    }
+
+    SECTION("as inner containers") {
+        std::vector<std::vector<int>> nested = {{1, 2}, {3}, {}, {4, 5, 6, 7, 8}};
+        auto res = nested | to<std::vector<small_vector<int, 4>>>();
+        REQUIRE(res.size() == 4);
+        CHECK(res[0] == small_vector<int, 4>{1, 2});
+        CHECK(res[0].is_inline());
+        CHECK(res[2].empty());
+        CHECK(!res[3].is_inline());
+
+        auto fixed = nested | std::views::take(3) | to<small_vector<static_vector<int, 2>, 4>>();
+        CHECK(fixed.size() == 3);
+        CHECK(fixed[1] == static_vector<int, 2>{3});
+    }
+}
+
+TEST_CASE("small_vector destroys its elements", "[small_vector]") {
+    auto p = std::make_shared<int>(0);
+    {
+        small_vector<std::shared_ptr<int>, 2> v(5, p);
+        CHECK(p.use_count() == 6);
+        v.erase(v.begin());
+        CHECK(p.use_count() == 5);
+        small_vector<std::shared_ptr<int>, 2> w(2, p);
+        v = w;
+        CHECK(p.use_count() == 5);
+    }
+    CHECK(p.use_count() == 1);
+}
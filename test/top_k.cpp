@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2020 - present Corentin Jabot
+
+Licenced under Boost Software License license. See LICENSE.md for details.
+*/
+
+#include <catch2/catch.hpp>
+#include <cor3ntin/rangesnext/generator.hpp>
+#include <cor3ntin/rangesnext/parallel.hpp>
+#include <cor3ntin/rangesnext/product.hpp>
+#include <cor3ntin/rangesnext/top_k.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace cor3ntin::rangesnext;
+namespace r = std::ranges;
+
+namespace {
+
+std::vector<int> shuffled(int n) {
+    std::vector<int> v(static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i)
+        v[static_cast<std::size_t>(i)] = i % 97;
+    std::shuffle(v.begin(), v.end(), std::mt19937());
+    return v;
+}
+
+std::vector<int> partial_sorted(std::vector<int> v, std::size_t k, auto comp) {
+    k = std::min(k, v.size());
+    r::partial_sort(v, v.begin() + static_cast<std::ptrdiff_t>(k), comp);
+    v.resize(k);
+    return v;
+}
+
+generator<int> countdown(int n) {
+    while (n > 0)
+        co_yield --n;
+}
+
+} // namespace
+
+TEST_CASE("top_k", "[top_k]") {
+    const auto v = shuffled(1000);
+
+    SECTION("as partial_sort") {
+        for (std::size_t k : {0u, 1u, 10u, 100u, 999u, 1000u, 5000u}) {
+            CHECK(top_k(v, k) == partial_sorted(v, k, r::less{}));
+            CHECK(top_k(v, k, r::greater{}) == partial_sorted(v, k, r::greater{}));
+        }
+    }
+
+    SECTION("projection") {
+        std::vector<std::string> words = {"ccc", "a", "bbbb", "dd"};
+        auto size = [](const std::string &w) { return w.size(); };
+        CHECK(top_k(words, 2, r::greater{}, size) == std::vector<std::string>{"bbbb", "ccc"});
+
+        struct item {
+            std::string name;
+            int score;
+            bool operator==(const item &) const = default;
+        };
+        std::vector<item> items = {{"a", 3}, {"b", 9}, {"c", 1}, {"d", 7}, {"e", 5}};
+        CHECK(top_k(items, 2, r::greater{}, &item::score) == std::vector<item>{{"b", 9}, {"d", 7}});
+        CHECK(top_k(items, 3, r::less{}, &item::name).back().name == "c");
+    }
+
+    SECTION("elements are projected once") {
+        std::vector<int> desc(1000);
+        for (int i = 0; i < 1000; ++i)
+            desc[static_cast<std::size_t>(i)] = 999 - i;
+        // counts the projections of the elements of desc, not of the copies in the heap
+        std::size_t projections = 0;
+        auto proj = [&](const int &x) {
+            if (&x >= desc.data() && &x < desc.data() + desc.size())
+                ++projections;
+            return x;
+        };
+        // every element is smaller than the front, and replaces it
+        CHECK(top_k(desc, 10, r::less{}, proj) == std::vector{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        CHECK(projections == 990);
+    }
+
+    SECTION("input ranges") {
+        CHECK(top_k(countdown(100), 3) == std::vector{0, 1, 2});
+        CHECK(top_k(countdown(100), 3, r::greater{}) == std::vector{99, 98, 97});
+    }
+
+    SECTION("product_view") {
+        std::vector<int> a = {3, 1, 2}, b = {20, 10};
+        auto best = top_k(product(a, b), 2);
+        STATIC_REQUIRE(std::same_as<decltype(best), std::vector<std::tuple<int, int>>>);
+        CHECK(best == std::vector{std::tuple{1, 10}, std::tuple{1, 20}});
+    }
+}
+
+TEST_CASE("nth_smallest", "[top_k]") {
+    const auto v = shuffled(1000);
+    auto sorted = v;
+    r::sort(sorted);
+    for (std::size_t n : {0u, 1u, 500u, 999u})
+        CHECK(nth_smallest(v, n) == sorted[n]);
+    CHECK(!nth_smallest(v, 1000));
+    CHECK(!nth_smallest(std::vector<int>{}, 0));
+    CHECK(nth_smallest(v, 0, r::greater{}) == 96);
+    CHECK(nth_smallest(countdown(10), 4) == 4);
+}
+
+TEST_CASE("par::top_k", "[top_k][Parallel]") {
+    thread_pool pool(4);
+    const auto v = shuffled(100000);
+
+    for (std::size_t k : {0u, 1u, 10u, 1000u}) {
+        for (std::size_t grain : {0u, 7u, 1000u}) {
+            CHECK(par::top_k(v, k, r::less{}, std::identity{}, grain, pool) == partial_sorted(v, k, r::less{}));
+            CHECK(par::top_k(v, k, r::greater{}, std::identity{}, grain, pool) ==
+                  partial_sorted(v, k, r::greater{}));
+        }
+    }
+
+    SECTION("product_view") {
+        auto p = product(r::views::iota(0, 300), r::views::iota(0, 300));
+        auto sum = [](auto t) { return std::get<0>(t) + std::get<1>(t); };
+        auto best = par::top_k(p, 3, r::greater{}, sum, 0, pool);
+        REQUIRE(best.size() == 3);
+        CHECK(best[0] == std::tuple{299, 299});
+        // equivalent elements are in an unspecified order
+        CHECK(r::is_permutation(best | r::views::drop(1), std::vector{std::tuple{298, 299}, std::tuple{299, 298}}));
+        CHECK(par::nth_smallest(p, 5, r::less{}, sum, 0, pool).has_value());
+    }
+
+    SECTION("non splittable ranges") {
+        CHECK(par::top_k(countdown(100), 2, r::less{}, std::identity{}, 0, pool) == std::vector{0, 1});
+        CHECK(par::nth_smallest(countdown(100), 99, r::less{}, std::identity{}, 0, pool) == 99);
+    }
+}